@@ -167,8 +167,27 @@ async def control_actuator(
         
         db.add(event)
         await db.commit()
-        
+
         logger.info(f"Actuator {actuator_id} controlled: {command.command}")
+
+        # Push through the CoAP Observe channel so an observing node reacts
+        # immediately; nodes that are not observing pick it up by polling.
+        # Emergency commands jump the per-node queue ahead of routine ones
+        try:
+            from app.services.command_dispatch import command_dispatch
+            priority = command.priority or (
+                "emergency" if command.command.lower().startswith("emergency") else "normal"
+            )
+            await command_dispatch.publish(node.node_id, {
+                "actuator_id": actuator_id,
+                "command": command.command,
+                "state": event.state,
+                "duration_seconds": event.duration_seconds,
+                "zone_id": actuator.zone_id,
+                "timestamp": event.time.isoformat() + "Z"
+            }, priority=priority)
+        except Exception as dispatch_error:
+            logger.warning(f"Could not push command to CoAP observers: {dispatch_error}")
         
         return {
             "actuator_id": actuator_id,
@@ -4,6 +4,7 @@ Handles time-series analytics, aggregations, and reporting
 """
 
 from fastapi import APIRouter, HTTPException, Depends, status, Query
+from fastapi.responses import StreamingResponse
 from fastapi.security import HTTPBearer
 from sqlalchemy import select, text
 from sqlalchemy.ext.asyncio import AsyncSession
@@ -11,8 +12,9 @@ from typing import List, Optional
 from datetime import datetime, timedelta
 import logging
 
-from database import get_db
+from database import get_db, get_read_db
 from auth import get_current_user, require_api_key, require_node_object
+from app.core.config import get_settings
 from models import User, Node
 from schemas import (
     SensorAnalyticsRequest, SensorAnalyticsResponse,
@@ -29,7 +31,7 @@ async def get_continuous_aggregates(
     zone: Optional[str] = Query(None, description="Zone ID filter"),
     period: str = Query("hourly", description="Time period (hourly, daily, weekly)"),
     days: int = Query(7, description="Number of days to include"),
-    db: AsyncSession = Depends(get_db),
+    db: AsyncSession = Depends(get_read_db),
     node: Node = Depends(require_node_object)
 ):
     """
@@ -132,12 +134,18 @@ async def get_downsampled_data(
     resolution: str = Query("1h", description="Time resolution (15m, 1h, 6h, 1d)"),
     start: datetime = Query(..., description="Start timestamp"),
     end: datetime = Query(..., description="End timestamp"),
-    db: AsyncSession = Depends(get_db),
+    method: str = Query("avg", description="Downsampling method (avg, lttb)"),
+    points: int = Query(2000, ge=3, le=20000, description="Target point count for lttb"),
+    db: AsyncSession = Depends(get_read_db),
     node: Node = Depends(require_node_object)
 ):
     """
     Get downsampled sensor data with compression analytics
     Optimized for long-term trend analysis
+
+    method=lttb uses the in-database Largest-Triangle-Three-Buckets function
+    (09_create_lttb_function.sql) to return ~points visually-faithful points
+    that preserve spikes bucket averaging would flatten
     """
     try:
         # Validate resolution
@@ -147,7 +155,59 @@ async def get_downsampled_data(
                 status_code=status.HTTP_400_BAD_REQUEST,
                 detail=f"Invalid resolution. Use: {', '.join(valid_resolutions)}"
             )
-        
+
+        # Validate method
+        valid_methods = ["avg", "lttb"]
+        if method not in valid_methods:
+            raise HTTPException(
+                status_code=status.HTTP_400_BAD_REQUEST,
+                detail=f"Invalid method. Use: {', '.join(valid_methods)}"
+            )
+
+        if method == "lttb":
+            # LTTB selects actual readings, so it only works per-metric
+            if metric == "all":
+                raise HTTPException(
+                    status_code=status.HTTP_400_BAD_REQUEST,
+                    detail="method=lttb requires a specific metric, not 'all'"
+                )
+
+            query = text("""
+                SELECT time, value
+                FROM timeseries.lttb_downsample(
+                    :node_id, :metric, :start_time, :end_time, :points, :zone_filter
+                )
+            """)
+            result = await db.execute(query, {
+                "node_id": node.node_id,
+                "metric": metric,
+                "start_time": start,
+                "end_time": end,
+                "points": points,
+                "zone_filter": zone
+            })
+            rows = result.fetchall()
+
+            data = [
+                {
+                    "time": row.time.isoformat() + "Z",
+                    metric: float(row.value)
+                }
+                for row in rows
+            ]
+
+            return {
+                "data": data,
+                "method": "lttb",
+                "target_points": points,
+                "returned_points": len(data),
+                "metric": metric,
+                "time_range": {
+                    "start": start.isoformat() + "Z",
+                    "end": end.isoformat() + "Z"
+                }
+            }
+
         # Build query for all metrics or specific metric
         if metric == "all":
             query = text("""
@@ -227,6 +287,7 @@ async def get_downsampled_data(
         
         return {
             "data": data,
+            "method": method,
             "compression_ratio": compression_ratio,
             "original_points": original_points,
             "compressed_points": compressed_points,
@@ -251,7 +312,7 @@ async def get_downsampled_data(
 async def get_zone_statistics(
     zone_id: str = Query(..., description="Zone ID"),
     days: int = Query(7, description="Number of days for statistics"),
-    db: AsyncSession = Depends(get_db),
+    db: AsyncSession = Depends(get_read_db),
     current_user: User = Depends(get_current_user)
 ):
     """
@@ -260,43 +321,103 @@ async def get_zone_statistics(
     try:
         end_time = datetime.utcnow()
         start_time = end_time - timedelta(days=days)
-        
-        # Query zone statistics from timeseries data
-        query = text("""
-            SELECT 
-                sensor_type,
-                avg(value) as avg_value,
-                min(value) as min_value,
-                max(value) as max_value,
-                count(*) as reading_count,
-                stddev(value) as stddev_value
-            FROM timeseries.sensor_readings
-            WHERE zone_id = :zone_id
-            AND time >= :start_time
-            AND time <= :end_time
-            GROUP BY sensor_type
-            ORDER BY sensor_type
-        """)
-        
+
         params = {
             "zone_id": zone_id,
             "start_time": start_time,
             "end_time": end_time
         }
-        
-        result = await db.execute(query, params)
-        rows = result.fetchall()
-        
+
+        # Preferred path: fold the pre-computed zone_aggregates rows that the
+        # zone rollup service maintains - constant-time per zone regardless
+        # of raw data volume. Per-metric counts live in the metadata JSON.
+        aggregate_query = text("""
+            SELECT
+                AVG(avg_temperature) as avg_temperature,
+                MIN(min_temperature) as min_temperature,
+                MAX(max_temperature) as max_temperature,
+                SUM((metadata->>'temperature_count')::int) as temperature_count,
+                AVG(avg_humidity) as avg_humidity,
+                MIN(min_humidity) as min_humidity,
+                MAX(max_humidity) as max_humidity,
+                SUM((metadata->>'humidity_count')::int) as humidity_count,
+                AVG(avg_soil_moisture) as avg_soil_moisture,
+                MIN(min_soil_moisture) as min_soil_moisture,
+                MAX(max_soil_moisture) as max_soil_moisture,
+                SUM((metadata->>'soil_moisture_count')::int) as soil_moisture_count,
+                AVG(avg_light) as avg_light,
+                SUM((metadata->>'light_count')::int) as light_count,
+                SUM(data_points_count) as total_points,
+                MIN(time) as first_bucket
+            FROM timeseries.zone_aggregates
+            WHERE zone_id = :zone_id
+            AND time >= :start_time
+            AND time <= :end_time
+        """)
+
+        # The rollup's high-water mark is seeded only one hour back and old
+        # history is never backfilled, so the aggregate can hold rows for
+        # just a fraction of the requested window. Only trust it when its
+        # earliest bucket reaches (within one bucket) the window start;
+        # otherwise fall back to the raw scan. Zones whose data genuinely
+        # starts mid-window also take the raw path - slower but correct.
+        coverage_tolerance = timedelta(
+            minutes=get_settings().ZONE_ROLLUP_BUCKET_MINUTES)
+
         statistics = {}
-        for row in rows:
-            statistics[row.sensor_type] = {
-                "avg": float(row.avg_value) if row.avg_value else None,
-                "min": float(row.min_value) if row.min_value else None,
-                "max": float(row.max_value) if row.max_value else None,
-                "stddev": float(row.stddev_value) if row.stddev_value else None,
-                "reading_count": row.reading_count
-            }
-        
+        try:
+            agg_result = await db.execute(aggregate_query, params)
+            agg = agg_result.fetchone()
+            if (agg and agg.total_points and agg.first_bucket is not None
+                    and agg.first_bucket.replace(tzinfo=None) <= start_time + coverage_tolerance):
+                for metric in ("temperature", "humidity", "soil_moisture", "light"):
+                    count = getattr(agg, f"{metric}_count", None)
+                    if not count:
+                        continue
+                    avg_value = getattr(agg, f"avg_{metric}", None)
+                    # stddev is not preserved through the rollup
+                    statistics[metric] = {
+                        "avg": float(avg_value) if avg_value is not None else None,
+                        "min": float(getattr(agg, f"min_{metric}")) if getattr(agg, f"min_{metric}", None) is not None else None,
+                        "max": float(getattr(agg, f"max_{metric}")) if getattr(agg, f"max_{metric}", None) is not None else None,
+                        "stddev": None,
+                        "reading_count": int(count)
+                    }
+        except Exception as agg_error:
+            logger.warning(f"⚠️ zone_aggregates lookup failed, falling back to raw readings: {agg_error}")
+            statistics = {}
+
+        if not statistics:
+            # Fallback: aggregate on demand over raw readings (rollup not yet
+            # caught up, or the aggregates table is empty)
+            query = text("""
+                SELECT
+                    sensor_type,
+                    avg(value) as avg_value,
+                    min(value) as min_value,
+                    max(value) as max_value,
+                    count(*) as reading_count,
+                    stddev(value) as stddev_value
+                FROM timeseries.sensor_readings
+                WHERE zone_id = :zone_id
+                AND time >= :start_time
+                AND time <= :end_time
+                GROUP BY sensor_type
+                ORDER BY sensor_type
+            """)
+
+            result = await db.execute(query, params)
+            rows = result.fetchall()
+
+            for row in rows:
+                statistics[row.sensor_type] = {
+                    "avg": float(row.avg_value) if row.avg_value else None,
+                    "min": float(row.min_value) if row.min_value else None,
+                    "max": float(row.max_value) if row.max_value else None,
+                    "stddev": float(row.stddev_value) if row.stddev_value else None,
+                    "reading_count": row.reading_count
+                }
+
         # Calculate plant health score (simplified)
         health_score = 85.0  # Default good health
         if "temperature" in statistics and statistics["temperature"]["avg"]:
@@ -327,3 +448,160 @@ async def get_zone_statistics(
             status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
             detail=f"Failed to get zone statistics: {str(e)}"
         )
+
+
+class _DrainableSink:
+    """Minimal file-like object pyarrow writers can write into while the
+    response generator drains it chunk by chunk - keeps memory constant
+    regardless of export size."""
+
+    def __init__(self):
+        self._chunks = []
+        self.closed = False
+
+    def write(self, data):
+        self._chunks.append(bytes(data))
+        return len(data)
+
+    def drain(self) -> bytes:
+        data = b"".join(self._chunks)
+        self._chunks = []
+        return data
+
+    def flush(self):
+        pass
+
+    def close(self):
+        self.closed = True
+
+    def tell(self) -> int:
+        # pyarrow's parquet writer tracks position itself; nothing to do
+        return 0
+
+
+@router.get("/export")
+async def export_sensor_readings(
+    start_time: datetime = Query(..., description="Start timestamp (ISO format)"),
+    end_time: datetime = Query(..., description="End timestamp (ISO format)"),
+    node_id: Optional[str] = Query(None, description="Filter by node ID"),
+    zone_id: Optional[str] = Query(None, description="Filter by zone ID"),
+    sensor_type: Optional[str] = Query(None, description="Filter by sensor type"),
+    format: str = Query("arrow", description="Export format (arrow, parquet)"),
+    batch_size: int = Query(50000, ge=1000, le=500000, description="Rows per record batch"),
+    db: AsyncSession = Depends(get_read_db),
+    current_user: User = Depends(get_current_user)
+):
+    """
+    Bulk export of raw sensor readings as an Arrow IPC stream or Parquet file
+
+    Streams from a server-side cursor on the read pool in record batches,
+    so a season-long 100M-row extract never materializes in API memory.
+    """
+    try:
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+    except ImportError:
+        raise HTTPException(
+            status_code=status.HTTP_501_NOT_IMPLEMENTED,
+            detail="pyarrow is not installed - bulk export unavailable"
+        )
+
+    if format not in ("arrow", "parquet"):
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail="format must be 'arrow' or 'parquet'"
+        )
+
+    query = text("""
+        SELECT
+            time,
+            node_id,
+            zone_id,
+            sensor_type::text AS sensor_type,
+            value::float8 AS value,
+            unit,
+            quality::text AS quality
+        FROM timeseries.sensor_readings
+        WHERE time >= :start_time
+        AND time < :end_time
+        AND (:node_filter IS NULL OR node_id = :node_filter)
+        AND (:zone_filter IS NULL OR zone_id = :zone_filter)
+        AND (:type_filter IS NULL OR sensor_type::text = :type_filter)
+        ORDER BY time
+    """).execution_options(yield_per=batch_size)
+
+    params = {
+        "start_time": start_time,
+        "end_time": end_time,
+        "node_filter": node_id,
+        "zone_filter": zone_id,
+        "type_filter": sensor_type
+    }
+
+    schema = pa.schema([
+        ("time", pa.timestamp("us", tz="UTC")),
+        ("node_id", pa.string()),
+        ("zone_id", pa.string()),
+        ("sensor_type", pa.string()),
+        ("value", pa.float64()),
+        ("unit", pa.string()),
+        ("quality", pa.string()),
+    ])
+
+    async def stream_export():
+        sink = _DrainableSink()
+        if format == "arrow":
+            writer = pa.ipc.new_stream(sink, schema)
+        else:
+            writer = pq.ParquetWriter(sink, schema, compression="zstd")
+
+        columns = {name: [] for name in schema.names}
+        rows_buffered = 0
+
+        def flush_batch():
+            batch = pa.record_batch(
+                [pa.array(columns[name], type=schema.field(name).type) for name in schema.names],
+                schema=schema
+            )
+            if format == "arrow":
+                writer.write_batch(batch)
+            else:
+                writer.write_table(pa.Table.from_batches([batch]))
+            for name in schema.names:
+                columns[name] = []
+
+        result = await db.stream(query, params)
+        async for row in result:
+            columns["time"].append(row.time)
+            columns["node_id"].append(row.node_id)
+            columns["zone_id"].append(row.zone_id)
+            columns["sensor_type"].append(row.sensor_type)
+            columns["value"].append(row.value)
+            columns["unit"].append(row.unit)
+            columns["quality"].append(row.quality)
+            rows_buffered += 1
+            if rows_buffered >= batch_size:
+                flush_batch()
+                rows_buffered = 0
+                yield sink.drain()
+
+        if rows_buffered:
+            flush_batch()
+        writer.close()
+        yield sink.drain()
+
+    if format == "arrow":
+        media_type = "application/vnd.apache.arrow.stream"
+        extension = "arrows"
+    else:
+        media_type = "application/x-parquet"
+        extension = "parquet"
+
+    filename = f"sensor_readings_{start_time.strftime('%Y%m%d')}_{end_time.strftime('%Y%m%d')}.{extension}"
+    logger.info(f"📦 Bulk export started by {current_user.username}: {params} as {format}")
+
+    return StreamingResponse(
+        stream_export(),
+        media_type=media_type,
+        headers={"Content-Disposition": f"attachment; filename={filename}"}
+    )
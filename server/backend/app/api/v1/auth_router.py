@@ -302,7 +302,10 @@ async def update_current_user(
                 current_user.role = user_update.role
             if user_update.is_active is not None:
                 current_user.is_active = user_update.is_active
-        
+
+            # Revoke cached sessions/claims so the change takes effect now
+            await redis_manager.invalidate_user_sessions(current_user.user_id)
+
         current_user.updated_at = datetime.utcnow()
         db.commit()
         db.refresh(current_user)
@@ -251,12 +251,25 @@ async def system_metrics(db: Session = Depends(get_async_db)):
         except Exception as e:
             logger.warning(f"Could not get node metrics: {str(e)}")
             node_metrics = {"error": "metrics_unavailable"}
-        
+
+        # CoAP ingest buffer metrics (queue depth, flush latency). These
+        # describe THIS process only: when ingest runs in the standalone
+        # coap_ingest service (COAP_ENABLED=false here) the API's buffer is
+        # idle and the real numbers live in the ingest workers' /metrics
+        ingest_metrics = {}
+        try:
+            from app.services.ingest_buffer import ingest_buffer
+            ingest_metrics = {"scope": "local_process", **ingest_buffer.stats()}
+        except Exception as e:
+            logger.warning(f"Could not get ingest buffer metrics: {str(e)}")
+            ingest_metrics = {"error": "metrics_unavailable"}
+
         metrics = {
             "timestamp": current_time,
             "database": db_metrics,
             "redis": redis_metrics,
             "nodes": node_metrics,
+            "ingest_buffer": ingest_metrics,
             "api": {
                 "uptime_seconds": 0,  # Would track actual uptime
                 "requests_last_hour": 0,  # Would track from middleware
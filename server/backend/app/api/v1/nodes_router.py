@@ -5,19 +5,22 @@ Node management, registration, and communication endpoints
 
 from fastapi import APIRouter, Depends, HTTPException, status, Query
 from sqlalchemy.orm import Session
-from sqlalchemy import and_, or_
+from sqlalchemy import and_, or_, select, tuple_
 from datetime import datetime, timedelta
 from typing import List, Optional
 import logging
 
 from database import get_async_db
-from auth import get_current_user, get_current_node, require_role, UserRole
+from auth import get_current_user, get_current_node, require_role, UserRole, invalidate_api_key_cache
 from schemas import (
-    NodeCreate, NodeUpdate, NodeResponse, NodeStats,
-    APIResponse, PaginationParams, PaginatedResponse
+    NodeCreate, NodeUpdate, NodeResponse, NodeStats, OTARolloutCreate,
+    APIResponse, PaginationParams, PaginatedResponse, CursorPaginatedResponse
 )
-from models import Node, Sensor, Actuator, Zone, NodeStatus
+from app.services.ota_rollout import ota_rollout
+from config import settings
+from models import Node, NodeHeartbeat, Sensor, Actuator, Zone, NodeStatus
 from redis_utils import redis_manager
+from helpers import encode_cursor, decode_cursor
 
 logger = logging.getLogger(__name__)
 
@@ -31,24 +34,45 @@ router = APIRouter(
     }
 )
 
+def _node_to_response(node: Node) -> NodeResponse:
+    """Convert a Node model to its response schema"""
+    return NodeResponse(
+        node_id=node.node_id,
+        name=node.name,
+        description=node.description,
+        location=node.location,
+        zone_id=node.zone_id,
+        status=node.status,
+        last_seen=node.last_seen,
+        configuration=node.configuration,
+        created_at=node.created_at,
+        updated_at=node.updated_at
+    )
+
 @router.get(
     "/",
-    response_model=PaginatedResponse,
     summary="List Nodes",
-    description="Get paginated list of all nodes with optional filtering"
+    description="Get paginated list of all nodes with optional filtering; pass cursor/limit for keyset pagination"
 )
 async def list_nodes(
     pagination: PaginationParams = Depends(),
     zone_id: Optional[str] = Query(None, description="Filter by zone ID"),
     status: Optional[NodeStatus] = Query(None, description="Filter by node status"),
     search: Optional[str] = Query(None, description="Search in name, location, or description"),
+    cursor: Optional[str] = Query(None, description="Keyset pagination cursor from a previous response"),
+    limit: Optional[int] = Query(None, ge=1, le=500, description="Page size; enables cursor pagination"),
     db: Session = Depends(get_async_db),
     current_user = Depends(require_role(UserRole.viewer))
 ):
-    """Get paginated list of nodes with filtering"""
+    """Get paginated list of nodes with filtering
+
+    cursor/limit switch to keyset pagination ordered by (created_at, node_id),
+    which stays O(page) however deep the page; page/size keep the old
+    offset behavior and total count
+    """
     try:
         query = db.query(Node)
-        
+
         # Apply filters
         filters = []
         if zone_id:
@@ -62,41 +86,65 @@ async def list_nodes(
                 Node.description.ilike(f"%{search}%")
             )
             filters.append(search_filter)
-        
+
         if filters:
             query = query.filter(and_(*filters))
-        
+
+        if cursor is not None or limit is not None:
+            # Keyset pagination: seek past the cursor instead of offsetting
+            page_size = limit or pagination.size
+            stmt = select(Node)
+            if filters:
+                stmt = stmt.where(and_(*filters))
+            stmt = stmt.order_by(Node.created_at, Node.node_id)
+
+            if cursor:
+                decoded = decode_cursor(cursor)
+                if not decoded:
+                    # 400 literal: the status query param shadows the fastapi
+                    # status module inside this handler
+                    raise HTTPException(
+                        status_code=400,
+                        detail={
+                            "error": "invalid_cursor",
+                            "message": "Invalid pagination cursor"
+                        }
+                    )
+                stmt = stmt.where(
+                    tuple_(Node.created_at, Node.node_id) > (decoded["created_at"], decoded["id"])
+                )
+
+            result = await db.execute(stmt.limit(page_size + 1))
+            nodes = result.scalars().all()
+            has_more = len(nodes) > page_size
+            nodes = nodes[:page_size]
+
+            items = [_node_to_response(node) for node in nodes]
+            next_cursor = None
+            if has_more and nodes:
+                next_cursor = encode_cursor(nodes[-1].created_at, nodes[-1].node_id)
+
+            return CursorPaginatedResponse(items=items, limit=page_size, next_cursor=next_cursor)
+
         # Get total count
         total = query.count()
-        
+
         # Apply pagination
         offset = (pagination.page - 1) * pagination.size
         nodes = query.offset(offset).limit(pagination.size).all()
-        
+
         # Convert to response format
-        node_responses = []
-        for node in nodes:
-            node_response = NodeResponse(
-                node_id=node.node_id,
-                name=node.name,
-                description=node.description,
-                location=node.location,
-                zone_id=node.zone_id,
-                status=node.status,
-                last_seen=node.last_seen,
-                configuration=node.configuration,
-                created_at=node.created_at,
-                updated_at=node.updated_at
-            )
-            node_responses.append(node_response)
-        
+        node_responses = [_node_to_response(node) for node in nodes]
+
         return PaginatedResponse.create(
             items=node_responses,
             total=total,
             page=pagination.page,
             size=pagination.size
         )
-        
+
+    except HTTPException:
+        raise
     except Exception as e:
         logger.error(f"List nodes failed: {str(e)}")
         raise HTTPException(
@@ -283,7 +331,14 @@ async def update_node(
         node.updated_at = datetime.utcnow()
         db.commit()
         db.refresh(node)
-        
+
+        # Drop cached auth so status changes take effect immediately
+        invalidate_api_key_cache(node.api_key)
+        try:
+            await redis_manager.invalidate_api_key(node.api_key)
+        except Exception as e:
+            logger.warning(f"Failed to invalidate Redis API key cache for {node_id}: {str(e)}")
+
         logger.info(f"Node updated: {node_id} by {current_user.username}")
         
         node_response = NodeResponse(
@@ -354,9 +409,17 @@ async def delete_node(
                 }
             )
         
+        deleted_api_key = node.api_key
         db.delete(node)
         db.commit()
-        
+
+        # Drop cached auth so the deleted node's key stops working now
+        invalidate_api_key_cache(deleted_api_key)
+        try:
+            await redis_manager.invalidate_api_key(deleted_api_key)
+        except Exception as e:
+            logger.warning(f"Failed to invalidate Redis API key cache for {node_id}: {str(e)}")
+
         logger.info(f"Node deleted: {node_id} by {current_user.username}")
         
         return APIResponse(
@@ -447,52 +510,104 @@ async def node_heartbeat(
     current_node_id: str = Depends(get_current_node),
     db: Session = Depends(get_async_db)
 ):
-    """Update node heartbeat and status"""
+    """Update node heartbeat and status.
+
+    Redis is the primary heartbeat store - every beat updates the live
+    state there. The timeseries.node_heartbeats hypertable only receives a
+    row when the reported status changes or every
+    HEARTBEAT_SNAPSHOT_INTERVAL_MINUTES as a coarse uptime snapshot, which
+    cuts heartbeat write volume by >90% while keeping the history the
+    health endpoints report on.
+    """
     try:
-        node = db.query(Node).filter(Node.node_id == current_node_id).first()
-        if not node:
-            raise HTTPException(
-                status_code=status.HTTP_404_NOT_FOUND,
-                detail={
-                    "error": "node_not_found",
-                    "message": f"Node {current_node_id} not found"
-                }
-            )
-        
-        # Update last seen
-        node.last_seen = datetime.utcnow()
-        
-        # Update status if node was inactive
-        if node.status == NodeStatus.inactive:
-            node.status = NodeStatus.active
-        
-        # Update configuration if provided
-        if status_data:
-            current_config = node.configuration or {}
-            current_config.update(status_data)
-            node.configuration = current_config
-        
-        node.updated_at = datetime.utcnow()
-        db.commit()
-        
-        # Cache heartbeat in Redis
-        await redis_manager.cache_node_heartbeat(current_node_id, datetime.utcnow())
-        
+        now = datetime.utcnow()
+        status_data = status_data or {}
+        reported_status = str(status_data.get("status", "active"))
+
+        # Decide whether this beat needs to spill to the database
+        previous = await redis_manager.get_node_heartbeat(current_node_id)
+        last_spill = None
+        if previous and previous.get("last_spill"):
+            try:
+                last_spill = datetime.fromisoformat(previous["last_spill"])
+            except ValueError:
+                pass
+
+        status_changed = not previous or previous.get("status") != reported_status
+        snapshot_due = (
+            last_spill is None
+            or now - last_spill >= timedelta(minutes=settings.HEARTBEAT_SNAPSHOT_INTERVAL_MINUTES)
+        )
+        spill = status_changed or snapshot_due
+
+        # Redis first: live state for dashboards and /nodes listings
+        spill_marker = now if spill else (last_spill or now)
+        await redis_manager.update_node_heartbeat(current_node_id, {
+            **status_data,
+            "status": reported_status,
+            "last_spill": spill_marker.isoformat()
+        })
+
+        response_status = reported_status
+        if spill:
+            result = await db.execute(select(Node).where(Node.node_id == current_node_id))
+            node = result.scalar_one_or_none()
+            if not node:
+                raise HTTPException(
+                    status_code=status.HTTP_404_NOT_FOUND,
+                    detail={
+                        "error": "node_not_found",
+                        "message": f"Node {current_node_id} not found"
+                    }
+                )
+
+            # Update last seen
+            node.last_seen = now
+
+            # Update status if node was inactive
+            if node.status == NodeStatus.inactive:
+                node.status = NodeStatus.active
+
+            # Update configuration if provided
+            if status_data:
+                current_config = node.configuration or {}
+                current_config.update(status_data)
+                node.configuration = current_config
+
+            node.updated_at = now
+
+            # Spill one history row into the hypertable
+            db.add(NodeHeartbeat(
+                time=now,
+                node_id=current_node_id,
+                status=reported_status,
+                uptime_seconds=status_data.get("uptime_seconds"),
+                memory_usage_mb=status_data.get("memory_usage_mb"),
+                cpu_usage_percent=status_data.get("cpu_usage_percent"),
+                signal_strength=status_data.get("signal_strength"),
+                temperature=status_data.get("temperature"),
+                free_storage_mb=status_data.get("free_storage_mb"),
+                meta_data=status_data.get("meta_data", {})
+            ))
+            await db.commit()
+            response_status = node.status.value
+
         return APIResponse(
             success=True,
             data={
                 "node_id": current_node_id,
-                "status": node.status.value,
-                "last_seen": node.last_seen
+                "status": response_status,
+                "last_seen": now,
+                "persisted": spill
             },
             message="Heartbeat recorded"
         )
-        
+
     except HTTPException:
         raise
     except Exception as e:
         logger.error(f"Node heartbeat failed: {str(e)}")
-        db.rollback()
+        await db.rollback()
         raise HTTPException(
             status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
             detail={
@@ -604,3 +719,166 @@ async def get_node_actuators(
                 "message": "Failed to retrieve node actuators"
             }
         )
+
+@router.post(
+    "/ota/rollout",
+    response_model=APIResponse,
+    summary="Start OTA Rollout",
+    description="Register a firmware release manifest and open the paced rollout (admin only)"
+)
+async def start_ota_rollout(
+    manifest: OTARolloutCreate,
+    current_user = Depends(require_role(UserRole.admin))
+):
+    """Start a fleet firmware rollout.
+
+    The manifest points at the full image and, when the build produced one,
+    a compressed binary diff against the previous release. Nodes whose
+    installed version matches delta_from download the patch (a few percent
+    of the image size) and apply it to their inactive partition; everyone
+    else falls back to the full image. Downloads are paced per access
+    point so the rollout does not starve telemetry on congested APs.
+    """
+    try:
+        if manifest.patch_url and not (manifest.delta_from and manifest.patch_sha256):
+            raise HTTPException(
+                status_code=status.HTTP_422_UNPROCESSABLE_ENTITY,
+                detail={
+                    "error": "incomplete_patch_manifest",
+                    "message": "patch_url requires delta_from and patch_sha256"
+                }
+            )
+
+        rollout = ota_rollout.start_rollout(
+            manifest.model_dump(),
+            started_by=current_user.username
+        )
+
+        return APIResponse(
+            success=True,
+            data=rollout,
+            message=f"OTA rollout started for version {manifest.version}"
+        )
+
+    except HTTPException:
+        raise
+    except Exception as e:
+        logger.error(f"OTA rollout start failed: {str(e)}")
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail={
+                "error": "ota_rollout_start_failed",
+                "message": "Failed to start OTA rollout"
+            }
+        )
+
+@router.get(
+    "/ota/rollout",
+    response_model=APIResponse,
+    summary="OTA Rollout Status",
+    description="Current rollout progress and per-AP download pacing"
+)
+async def get_ota_rollout_status(
+    current_user = Depends(require_role(UserRole.viewer))
+):
+    """Get rollout progress counters and in-flight downloads per access point"""
+    return APIResponse(
+        success=True,
+        data=ota_rollout.stats(),
+        message="OTA rollout status"
+    )
+
+@router.delete(
+    "/ota/rollout",
+    response_model=APIResponse,
+    summary="Cancel OTA Rollout",
+    description="Close the active rollout (admin only)"
+)
+async def cancel_ota_rollout(
+    current_user = Depends(require_role(UserRole.admin))
+):
+    """Cancel the active rollout; checking-in nodes are told nothing is pending"""
+    try:
+        ota_rollout.cancel_rollout()
+        return APIResponse(
+            success=True,
+            message="OTA rollout cancelled"
+        )
+    except Exception as e:
+        logger.error(f"OTA rollout cancel failed: {str(e)}")
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail={
+                "error": "ota_rollout_cancel_failed",
+                "message": "Failed to cancel OTA rollout"
+            }
+        )
+
+@router.post(
+    "/ota/check",
+    response_model=dict,
+    summary="OTA Update Check",
+    description="Node asks for a paced download slot (API key required)"
+)
+async def ota_update_check(
+    check_data: dict = None,
+    current_node_id: str = Depends(get_current_node)
+):
+    """Node update check-in.
+
+    Body carries the node's installed firmware version and the BSSID of
+    the access point it is associated with, e.g.
+    {"current_version": "1.4.2", "access_point": "aa:bb:cc:dd:ee:ff"}.
+    The response either grants a download (with the patch or full image
+    URL and checksum) or asks the node to retry after a backoff when its
+    AP already has the maximum concurrent downloads.
+    """
+    try:
+        check_data = check_data or {}
+        return ota_rollout.check_in(
+            current_node_id,
+            current_version=check_data.get("current_version"),
+            access_point=check_data.get("access_point")
+        )
+    except Exception as e:
+        logger.error(f"OTA check failed for node {current_node_id}: {str(e)}")
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail={
+                "error": "ota_check_failed",
+                "message": "OTA update check failed"
+            }
+        )
+
+@router.post(
+    "/ota/report",
+    response_model=APIResponse,
+    summary="OTA Result Report",
+    description="Node reports download/apply outcome, freeing its slot (API key required)"
+)
+async def ota_report_result(
+    report_data: dict = None,
+    current_node_id: str = Depends(get_current_node)
+):
+    """Node reports the rollout outcome, e.g. {"success": true} or
+    {"success": false, "detail": "patch checksum mismatch"}"""
+    try:
+        report_data = report_data or {}
+        ota_rollout.report_result(
+            current_node_id,
+            success=bool(report_data.get("success")),
+            detail=report_data.get("detail")
+        )
+        return APIResponse(
+            success=True,
+            message="OTA result recorded"
+        )
+    except Exception as e:
+        logger.error(f"OTA report failed for node {current_node_id}: {str(e)}")
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail={
+                "error": "ota_report_failed",
+                "message": "Failed to record OTA result"
+            }
+        )
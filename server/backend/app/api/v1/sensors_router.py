@@ -3,16 +3,19 @@ Smart Greenhouse IoT System - Sensor Data Routes
 Handles sensor registration, data submission, and time-series queries
 """
 
-from fastapi import APIRouter, HTTPException, Depends, status, Query, Body
+from fastapi import APIRouter, HTTPException, Depends, status, Query, Body, BackgroundTasks, Request
+from fastapi.responses import JSONResponse
 from fastapi.security import HTTPBearer, HTTPAuthorizationCredentials
-from sqlalchemy import select, and_, desc, func, text
+from sqlalchemy import select, and_, desc, func, text, insert, tuple_
 from sqlalchemy.ext.asyncio import AsyncSession
 from typing import List, Optional, Dict, Any
 from datetime import datetime, timedelta
 import logging
 import uuid
 
-from database import get_db
+from database import get_db, get_read_db, AsyncSessionLocal
+from redis_utils import redis_manager
+from helpers import encode_cursor, decode_cursor
 from auth import require_api_key, require_node_object, get_current_user
 from models import (
     SensorReading, Sensor, Node, User, 
@@ -20,8 +23,9 @@ from models import (
 )
 from schemas import (
     SensorCreate, SensorUpdate, SensorResponse,
-    SensorReadingBatch, SensorTypeEnum
+    SensorReadingBatch, SensorTypeEnum, CursorPaginatedResponse
 )
+from app.services.ingest_buffer import upsert_latest_readings
 
 logger = logging.getLogger(__name__)
 router = APIRouter()
@@ -100,21 +104,26 @@ async def register_sensor(
             detail=f"Failed to register sensor: {str(e)}"
         )
 
-@router.get("/sensors", response_model=List[SensorResponse])
+@router.get("/sensors")
 async def list_sensors(
     node_id: Optional[str] = Query(None, description="Filter by node ID"),
     zone_id: Optional[str] = Query(None, description="Filter by zone ID"),
     sensor_type: Optional[SensorTypeEnum] = Query(None, description="Filter by sensor type"),
     active_only: bool = Query(True, description="Show only active sensors"),
+    cursor: Optional[str] = Query(None, description="Keyset pagination cursor from a previous response"),
+    limit: Optional[int] = Query(None, ge=1, le=500, description="Page size; enables cursor pagination"),
     db: AsyncSession = Depends(get_db),
     current_user: User = Depends(get_current_user)
 ):
     """
     List all sensors with optional filtering
+
+    Pass limit= (and subsequently cursor=) for keyset pagination ordered by
+    (created_at, sensor_id); without them the full list is returned as before
     """
     try:
         query = select(Sensor)
-        
+
         # Apply filters
         if node_id:
             query = query.where(Sensor.node_id == node_id)
@@ -124,29 +133,45 @@ async def list_sensors(
             query = query.where(Sensor.sensor_type == sensor_type)
         if active_only:
             query = query.where(Sensor.is_active == True)
-        
+
+        if cursor is not None or limit is not None:
+            # Keyset pagination: seek past the cursor instead of offsetting
+            page_size = limit or 100
+            query = query.order_by(Sensor.created_at, Sensor.sensor_id)
+
+            if cursor:
+                decoded = decode_cursor(cursor)
+                if not decoded:
+                    raise HTTPException(
+                        status_code=status.HTTP_400_BAD_REQUEST,
+                        detail="Invalid pagination cursor"
+                    )
+                query = query.where(
+                    tuple_(Sensor.created_at, Sensor.sensor_id) > (decoded["created_at"], decoded["id"])
+                )
+
+            # Fetch one extra row to know whether another page exists
+            result = await db.execute(query.limit(page_size + 1))
+            sensors = result.scalars().all()
+            has_more = len(sensors) > page_size
+            sensors = sensors[:page_size]
+
+            items = [_sensor_to_response(sensor) for sensor in sensors]
+            next_cursor = None
+            if has_more and sensors:
+                next_cursor = encode_cursor(sensors[-1].created_at, sensors[-1].sensor_id)
+
+            return CursorPaginatedResponse(items=items, limit=page_size, next_cursor=next_cursor)
+
         query = query.order_by(Sensor.node_id, Sensor.zone_id, Sensor.sensor_type)
-        
+
         result = await db.execute(query)
         sensors = result.scalars().all()
-        
-        return [
-            SensorResponse(
-                sensor_id=sensor.sensor_id,
-                node_id=sensor.node_id,
-                zone_id=sensor.zone_id,
-                sensor_type=sensor.sensor_type,
-                pin_number=sensor.pin_number,
-                calibration_offset=sensor.calibration_offset,
-                calibration_multiplier=sensor.calibration_multiplier,
-                description=sensor.description,
-                is_active=sensor.is_active,
-                created_at=sensor.created_at,
-                updated_at=sensor.updated_at
-            )
-            for sensor in sensors
-        ]
-        
+
+        return [_sensor_to_response(sensor) for sensor in sensors]
+
+    except HTTPException:
+        raise
     except Exception as e:
         logger.error(f"Error listing sensors: {str(e)}")
         raise HTTPException(
@@ -367,66 +392,131 @@ async def submit_sensor_data(
             detail=f"Failed to submit sensor data: {str(e)}"
         )
 
+async def _build_batch_rows(batch: SensorReadingBatch, node: Node, db: AsyncSession):
+    """Validate a batch against the node's sensors and build insert rows"""
+    # One sensor lookup for the whole batch instead of one per reading
+    sensor_ids = {reading_data.sensor_id for reading_data in batch.readings}
+    sensor_query = select(Sensor).where(
+        and_(
+            Sensor.sensor_id.in_(sensor_ids),
+            Sensor.node_id == node.node_id,
+            Sensor.is_active == True
+        )
+    )
+    result = await db.execute(sensor_query)
+    sensors = {str(sensor.sensor_id): sensor for sensor in result.scalars().all()}
+
+    rows = []
+    skipped = 0
+    for reading_data in batch.readings:
+        sensor = sensors.get(str(reading_data.sensor_id))
+        if not sensor:
+            logger.warning(f"Sensor {reading_data.sensor_id} not found for node {node.node_id}")
+            skipped += 1
+            continue
+
+        # Apply calibration
+        calibrated_value = (reading_data.value * float(sensor.calibration_multiplier)) + float(sensor.calibration_offset)
+
+        rows.append({
+            "time": reading_data.timestamp or datetime.utcnow(),
+            "node_id": node.node_id,
+            "zone_id": sensor.zone_id,
+            "sensor_id": sensor.sensor_id,
+            "sensor_type": sensor.sensor_type,
+            "value": calibrated_value,
+            "unit": _get_sensor_unit(sensor.sensor_type),
+            "quality": DataQuality.good if reading_data.quality is None else DataQuality.good if reading_data.quality > 0.8 else DataQuality.poor,
+            "meta_data": {"raw_value": reading_data.value, "calibrated": True, "quality_score": reading_data.quality}
+        })
+
+    return rows, skipped
+
+async def _flush_batch_job(job_id: str, node_id: str, rows: List[Dict[str, Any]]):
+    """Background task: land an accepted batch and record the job outcome"""
+    try:
+        async with AsyncSessionLocal() as session:
+            if rows:
+                await session.execute(insert(SensorReading), rows)
+                await upsert_latest_readings(session, rows)
+            await session.commit()
+
+        await redis_manager.set_batch_job_status(job_id, {
+            "job_id": job_id,
+            "node_id": node_id,
+            "status": "completed",
+            "readings_created": len(rows),
+            "completed_at": datetime.utcnow().isoformat() + "Z"
+        })
+        logger.info(f"Batch job {job_id} completed: {len(rows)} readings for node {node_id}")
+
+    except Exception as e:
+        logger.error(f"Batch job {job_id} failed for node {node_id}: {str(e)}")
+        await redis_manager.set_batch_job_status(job_id, {
+            "job_id": job_id,
+            "node_id": node_id,
+            "status": "failed",
+            "error": str(e),
+            "failed_at": datetime.utcnow().isoformat() + "Z"
+        })
+
 @router.post("/sensor-data/batch", status_code=status.HTTP_201_CREATED)
 async def submit_sensor_data_batch(
     batch: SensorReadingBatch,
+    background_tasks: BackgroundTasks,
+    request: Request,
+    async_mode: bool = Query(False, description="Return 202 immediately and land the batch in the background"),
     db: AsyncSession = Depends(get_db),
     node: Node = Depends(require_node_object)
 ):
     """
     Submit multiple sensor readings in batch
-    Optimized for high-frequency data collection
+    Optimized for high-frequency data collection and backfill replays:
+    the whole batch lands with a single multi-row insert
     """
     try:
-        readings_created = 0
-        
-        for reading_data in batch.readings:
-            # Verify sensor exists and belongs to this node
-            sensor_query = select(Sensor).where(
-                and_(
-                    Sensor.sensor_id == reading_data.sensor_id,
-                    Sensor.node_id == node.node_id,
-                    Sensor.is_active == True
-                )
-            )
-            
-            result = await db.execute(sensor_query)
-            sensor = result.scalar_one_or_none()
-            
-            if not sensor:
-                logger.warning(f"Sensor {reading_data.sensor_id} not found for node {node.node_id}")
-                continue
-            
-            # Apply calibration
-            calibrated_value = (reading_data.value * float(sensor.calibration_multiplier)) + float(sensor.calibration_offset)
-            
-            # Create sensor reading
-            reading = SensorReading(
-                time=reading_data.timestamp or datetime.utcnow(),
-                node_id=node.node_id,
-                zone_id=sensor.zone_id,
-                sensor_id=sensor.sensor_id,
-                sensor_type=sensor.sensor_type,
-                value=calibrated_value,
-                unit=_get_sensor_unit(sensor.sensor_type),
-                quality=DataQuality.good if reading_data.quality is None else DataQuality.good if reading_data.quality > 0.8 else DataQuality.poor,
-                meta_data={"raw_value": reading_data.value, "calibrated": True, "quality_score": reading_data.quality}
+        rows, skipped = await _build_batch_rows(batch, node, db)
+
+        if async_mode:
+            # Accept now, insert in the background, poll via job_id
+            job_id = str(uuid.uuid4())
+            await redis_manager.set_batch_job_status(job_id, {
+                "job_id": job_id,
+                "node_id": node.node_id,
+                "status": "queued",
+                "readings_accepted": len(rows),
+                "readings_skipped": skipped,
+                "queued_at": datetime.utcnow().isoformat() + "Z"
+            })
+            background_tasks.add_task(_flush_batch_job, job_id, node.node_id, rows)
+
+            return JSONResponse(
+                status_code=status.HTTP_202_ACCEPTED,
+                content={
+                    "status": "accepted",
+                    "job_id": job_id,
+                    "readings_accepted": len(rows),
+                    "readings_skipped": skipped,
+                    # Resolve against the route so the URL stays correct
+                    # however this router is mounted
+                    "poll_url": str(request.url_for("get_batch_job_status", job_id=job_id))
+                }
             )
-            
-            db.add(reading)
-            readings_created += 1
-        
+
+        if rows:
+            await db.execute(insert(SensorReading), rows)
+            await upsert_latest_readings(db, rows)
         await db.commit()
-        
-        logger.info(f"Node {node.node_id} submitted {readings_created} batch sensor readings")
-        
+
+        logger.info(f"Node {node.node_id} submitted {len(rows)} batch sensor readings")
+
         return {
             "status": "success",
             "readings_processed": len(batch.readings),
-            "readings_created": readings_created,
+            "readings_created": len(rows),
             "timestamp": datetime.utcnow().isoformat() + "Z"
         }
-        
+
     except Exception as e:
         logger.error(f"Error submitting batch sensor data from {node.node_id}: {str(e)}")
         await db.rollback()
@@ -435,6 +525,34 @@ async def submit_sensor_data_batch(
             detail=f"Failed to submit batch sensor data: {str(e)}"
         )
 
+@router.get("/sensor-data/batch/{job_id}")
+async def get_batch_job_status(
+    job_id: str,
+    node: Node = Depends(require_node_object)
+):
+    """
+    Poll the status of an async batch submission
+    """
+    try:
+        job_status = await redis_manager.get_batch_job_status(job_id)
+
+        if not job_status or job_status.get("node_id") != node.node_id:
+            raise HTTPException(
+                status_code=status.HTTP_404_NOT_FOUND,
+                detail=f"Batch job {job_id} not found"
+            )
+
+        return job_status
+
+    except HTTPException:
+        raise
+    except Exception as e:
+        logger.error(f"Error getting batch job status {job_id}: {str(e)}")
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail=f"Failed to get batch job status: {str(e)}"
+        )
+
 # ============================================================================
 # SENSOR DATA QUERY ENDPOINTS
 # ============================================================================
@@ -444,32 +562,47 @@ async def get_latest_sensor_data(
     node_id: Optional[str] = Query(None, description="Filter by node ID"),
     zone_id: Optional[str] = Query(None, description="Filter by zone ID"),
     sensor_type: Optional[SensorTypeEnum] = Query(None, description="Filter by sensor type"),
-    db: AsyncSession = Depends(get_db),
+    db: AsyncSession = Depends(get_read_db),
     node: Node = Depends(require_node_object)
 ):
     """
     Get latest sensor readings for a node
     """
     try:
-        # Build query for latest readings
+        # Current state lives in timeseries.latest_readings (one row per
+        # sensor, upserted at ingest time), so this is an index lookup that
+        # never scans the hypertable no matter how much history exists
         query = text("""
-            SELECT DISTINCT ON (sensor_id) 
-                time, node_id, zone_id, sensor_id, sensor_type, value, unit, quality
-            FROM timeseries.sensor_readings
+            SELECT time, node_id, zone_id, sensor_id, sensor_type, value, unit, quality
+            FROM timeseries.latest_readings
             WHERE node_id = :node_id
             AND (:zone_filter IS NULL OR zone_id = :zone_filter)
             AND (:type_filter IS NULL OR sensor_type = :type_filter)
-            ORDER BY sensor_id, time DESC
         """)
-        
+
         params = {
             "node_id": node.node_id,
             "zone_filter": zone_id,
             "type_filter": sensor_type.value if sensor_type else None
         }
-        
+
         result = await db.execute(query, params)
         readings = result.fetchall()
+
+        if not readings:
+            # Node not seeded yet (fresh table before the backfill in
+            # 11_create_latest_readings.sql ran) - fall back to the scan
+            fallback_query = text("""
+                SELECT DISTINCT ON (sensor_id)
+                    time, node_id, zone_id, sensor_id, sensor_type, value, unit, quality
+                FROM timeseries.sensor_readings
+                WHERE node_id = :node_id
+                AND (:zone_filter IS NULL OR zone_id = :zone_filter)
+                AND (:type_filter IS NULL OR sensor_type = :type_filter)
+                ORDER BY sensor_id, time DESC
+            """)
+            result = await db.execute(fallback_query, params)
+            readings = result.fetchall()
         
         # Group readings by type for easy consumption
         data = {}
@@ -504,7 +637,7 @@ async def get_sensor_data_history(
     interval: Optional[str] = Query("1h", description="Aggregation interval (1m, 5m, 15m, 1h, 1d)"),
     zone_id: Optional[str] = Query(None, description="Filter by zone ID"),
     aggregation: str = Query("avg", description="Aggregation function (avg, min, max, sum)"),
-    db: AsyncSession = Depends(get_db),
+    db: AsyncSession = Depends(get_read_db),
     node: Node = Depends(require_node_object)
 ):
     """
@@ -532,42 +665,82 @@ async def get_sensor_data_history(
         sensor_types = []
         if fields:
             sensor_types = [t.strip() for t in fields.split(",")]
-        
+
+        # Route to the cheapest source for the requested range: raw readings
+        # for short windows, continuous aggregates for dashboard-scale ranges
+        # (hourly_sensor_stats / daily_sensor_stats, see 05_create_continuous_aggregates.sql)
+        interval_minutes = {"1m": 1, "5m": 5, "15m": 15, "30m": 30, "1h": 60, "6h": 360, "12h": 720, "1d": 1440}[interval]
+        range_hours = (end - start).total_seconds() / 3600.0
+
+        if range_hours < 48:
+            source = "raw"
+        elif range_hours < 60 * 24:
+            source = "hourly"
+        else:
+            source = "daily"
+
+        if source == "raw":
+            from_table = "timeseries.sensor_readings"
+            time_column = "time"
+            value_expr = f"{aggregation}(value)"
+            points_expr = "count(*)"
+        else:
+            from_table = f"timeseries.{source}_sensor_stats"
+            time_column = "time_bucket"
+            # Re-aggregate the pre-computed stats; avg/sum stay exact by
+            # weighting with the per-bucket data_points counts
+            value_expr = {
+                "avg": "SUM(avg_value * data_points) / NULLIF(SUM(data_points), 0)",
+                "min": "MIN(min_value)",
+                "max": "MAX(max_value)",
+                "sum": "SUM(avg_value * data_points)",
+                "count": "SUM(data_points)"
+            }[aggregation]
+            points_expr = "SUM(data_points)"
+            # Requested interval cannot be finer than the aggregate's bucket
+            tier_minutes = 60 if source == "hourly" else 1440
+            if interval_minutes < tier_minutes:
+                interval = "1h" if source == "hourly" else "1d"
+
         # Build dynamic query
-        where_clauses = ["node_id = :node_id", "time >= :start_time", "time <= :end_time"]
+        where_clauses = [
+            "node_id = :node_id",
+            f"{time_column} >= :start_time",
+            f"{time_column} <= :end_time"
+        ]
         params = {
             "node_id": node.node_id,
             "start_time": start,
             "end_time": end
         }
-        
+
         if zone_id:
             where_clauses.append("zone_id = :zone_id")
             params["zone_id"] = zone_id
-            
+
         if sensor_types:
             where_clauses.append("sensor_type = ANY(:sensor_types)")
             params["sensor_types"] = sensor_types
-        
+
         where_clause = " AND ".join(where_clauses)
-        
+
         query = text(f"""
-            SELECT 
-                time_bucket(:interval, time) as time_bucket,
+            SELECT
+                time_bucket(:interval, {time_column}) as time_bucket,
                 sensor_type,
-                {aggregation}(value) as value,
-                count(*) as data_points
-            FROM timeseries.sensor_readings
+                {value_expr} as value,
+                {points_expr} as data_points
+            FROM {from_table}
             WHERE {where_clause}
             GROUP BY time_bucket, sensor_type
             ORDER BY time_bucket, sensor_type
         """)
-        
+
         params["interval"] = interval
-        
+
         result = await db.execute(query, params)
         rows = result.fetchall()
-        
+
         # Format response
         data = []
         for row in rows:
@@ -575,13 +748,14 @@ async def get_sensor_data_history(
                 "timestamp": row.time_bucket.isoformat() + "Z",
                 "sensor_type": row.sensor_type,
                 "value": float(row.value),
-                "data_points": row.data_points
+                "data_points": int(row.data_points)
             })
-        
+
         return {
             "data": data,
             "aggregation": aggregation,
             "interval": interval,
+            "source": source,
             "total_points": len(data),
             "query_time_ms": 0,  # Could add timing if needed
             "node_id": node.node_id,
@@ -604,6 +778,22 @@ async def get_sensor_data_history(
 # HELPER FUNCTIONS
 # ============================================================================
 
+def _sensor_to_response(sensor: Sensor) -> SensorResponse:
+    """Convert a Sensor model to its response schema"""
+    return SensorResponse(
+        sensor_id=sensor.sensor_id,
+        node_id=sensor.node_id,
+        zone_id=sensor.zone_id,
+        sensor_type=sensor.sensor_type,
+        pin_number=sensor.pin_number,
+        calibration_offset=sensor.calibration_offset,
+        calibration_multiplier=sensor.calibration_multiplier,
+        description=sensor.description,
+        is_active=sensor.is_active,
+        created_at=sensor.created_at,
+        updated_at=sensor.updated_at
+    )
+
 def _get_sensor_unit(sensor_type: str) -> str:
     """Get the standard unit for a sensor type"""
     units = {
@@ -5,7 +5,7 @@ User management endpoints for administrators
 
 from fastapi import APIRouter, Depends, HTTPException, status, Query
 from sqlalchemy.orm import Session
-from sqlalchemy import and_, or_
+from sqlalchemy import and_, or_, select, tuple_
 from datetime import datetime
 from typing import List, Optional
 import logging
@@ -13,11 +13,12 @@ import logging
 from database import get_async_db
 from auth import get_current_user, require_role, UserRole
 from schemas import (
-    UserCreate, UserUpdate, UserResponse, APIResponse, 
-    PaginationParams, PaginatedResponse
+    UserCreate, UserUpdate, UserResponse, APIResponse,
+    PaginationParams, PaginatedResponse, CursorPaginatedResponse
 )
 from models import User
 from redis_utils import redis_manager
+from helpers import encode_cursor, decode_cursor
 
 logger = logging.getLogger(__name__)
 
@@ -32,24 +33,42 @@ router = APIRouter(
     }
 )
 
+def _user_to_response(user: User) -> UserResponse:
+    """Convert a User model to its response schema"""
+    return UserResponse(
+        user_id=user.user_id,
+        username=user.username,
+        email=user.email,
+        full_name=user.full_name,
+        role=user.role,
+        is_active=user.is_active,
+        created_at=user.created_at,
+        last_login=user.last_login
+    )
+
 @router.get(
     "/",
-    response_model=PaginatedResponse,
     summary="List Users",
-    description="Get paginated list of all users (admin only)"
+    description="Get paginated list of all users (admin only); pass cursor/limit for keyset pagination"
 )
 async def list_users(
     pagination: PaginationParams = Depends(),
     role: Optional[UserRole] = Query(None, description="Filter by user role"),
     is_active: Optional[bool] = Query(None, description="Filter by active status"),
     search: Optional[str] = Query(None, description="Search in username, email, or full name"),
+    cursor: Optional[str] = Query(None, description="Keyset pagination cursor from a previous response"),
+    limit: Optional[int] = Query(None, ge=1, le=500, description="Page size; enables cursor pagination"),
     db: Session = Depends(get_async_db),
     current_user: User = Depends(get_current_user)
 ):
-    """Get paginated list of users with filtering"""
+    """Get paginated list of users with filtering
+
+    cursor/limit switch to keyset pagination ordered by (created_at, user_id);
+    page/size keep the old offset behavior and total count
+    """
     try:
         query = db.query(User)
-        
+
         # Apply filters
         filters = []
         if role:
@@ -63,39 +82,63 @@ async def list_users(
                 User.full_name.ilike(f"%{search}%")
             )
             filters.append(search_filter)
-        
+
         if filters:
             query = query.filter(and_(*filters))
-        
+
+        if cursor is not None or limit is not None:
+            # Keyset pagination: seek past the cursor instead of offsetting
+            page_size = limit or pagination.size
+            stmt = select(User)
+            if filters:
+                stmt = stmt.where(and_(*filters))
+            stmt = stmt.order_by(User.created_at, User.user_id)
+
+            if cursor:
+                decoded = decode_cursor(cursor)
+                if not decoded:
+                    raise HTTPException(
+                        status_code=status.HTTP_400_BAD_REQUEST,
+                        detail={
+                            "error": "invalid_cursor",
+                            "message": "Invalid pagination cursor"
+                        }
+                    )
+                stmt = stmt.where(
+                    tuple_(User.created_at, User.user_id) > (decoded["created_at"], decoded["id"])
+                )
+
+            result = await db.execute(stmt.limit(page_size + 1))
+            users = result.scalars().all()
+            has_more = len(users) > page_size
+            users = users[:page_size]
+
+            items = [_user_to_response(user) for user in users]
+            next_cursor = None
+            if has_more and users:
+                next_cursor = encode_cursor(users[-1].created_at, users[-1].user_id)
+
+            return CursorPaginatedResponse(items=items, limit=page_size, next_cursor=next_cursor)
+
         # Get total count
         total = query.count()
-        
+
         # Apply pagination and ordering
         offset = (pagination.page - 1) * pagination.size
         users = query.order_by(User.created_at.desc()).offset(offset).limit(pagination.size).all()
-        
+
         # Convert to response format
-        user_responses = []
-        for user in users:
-            user_response = UserResponse(
-                user_id=user.user_id,
-                username=user.username,
-                email=user.email,
-                full_name=user.full_name,
-                role=user.role,
-                is_active=user.is_active,
-                created_at=user.created_at,
-                last_login=user.last_login
-            )
-            user_responses.append(user_response)
-        
+        user_responses = [_user_to_response(user) for user in users]
+
         return PaginatedResponse.create(
             items=user_responses,
             total=total,
             page=pagination.page,
             size=pagination.size
         )
-        
+
+    except HTTPException:
+        raise
     except Exception as e:
         logger.error(f"List users failed: {str(e)}")
         raise HTTPException(
@@ -208,6 +251,8 @@ async def update_user(
             user.full_name = user_update.full_name
         if user_update.role is not None:
             user.role = user_update.role
+            # Revoke cached sessions/claims so no request keeps the old role
+            await redis_manager.invalidate_user_sessions(user_id)
         if user_update.is_active is not None:
             user.is_active = user_update.is_active
             
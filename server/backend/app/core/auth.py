@@ -6,6 +6,9 @@ JWT-based user authentication and API key authentication for nodes
 import jwt
 from jwt.exceptions import PyJWTError
 import bcrypt
+import hashlib
+import time
+from collections import OrderedDict
 from datetime import datetime, timedelta
 from typing import Optional, Dict, Any
 from fastapi import HTTPException, Depends, Security, status
@@ -33,6 +36,49 @@ except ImportError:
 security = HTTPBearer()
 api_key_header = APIKeyHeader(name="X-API-Key", auto_error=False)
 
+# In-process API key cache (tier 1, in front of Redis)
+# Keyed on the hashed key so raw credentials never sit in memory dumps;
+# bounded LRU with a short TTL so revocations converge quickly even
+# without explicit invalidation
+API_KEY_CACHE_MAX_SIZE = 4096
+API_KEY_CACHE_LOCAL_TTL = 60.0
+_api_key_cache: "OrderedDict[str, tuple]" = OrderedDict()
+
+def _hash_api_key(api_key: str) -> str:
+    return hashlib.sha256(api_key.encode('utf-8')).hexdigest()
+
+def _api_key_cache_get(api_key: str) -> Optional[str]:
+    """Local LRU lookup; returns node_id or None"""
+    hashed = _hash_api_key(api_key)
+    entry = _api_key_cache.get(hashed)
+    if not entry:
+        return None
+    expires, node_id = entry
+    if time.monotonic() >= expires:
+        del _api_key_cache[hashed]
+        return None
+    _api_key_cache.move_to_end(hashed)
+    return node_id
+
+def _api_key_cache_put(api_key: str, node_id: str) -> None:
+    """Insert into the local LRU, evicting the oldest entry when full"""
+    hashed = _hash_api_key(api_key)
+    _api_key_cache[hashed] = (time.monotonic() + API_KEY_CACHE_LOCAL_TTL, node_id)
+    _api_key_cache.move_to_end(hashed)
+    while len(_api_key_cache) > API_KEY_CACHE_MAX_SIZE:
+        _api_key_cache.popitem(last=False)
+
+def invalidate_api_key_cache(api_key: Optional[str] = None) -> None:
+    """Drop one API key (or all of them) from the in-process cache
+
+    Call this whenever a node's key is rotated, or a node is deactivated
+    or deleted, so stale auth cannot outlive the local TTL.
+    """
+    if api_key is None:
+        _api_key_cache.clear()
+        return
+    _api_key_cache.pop(_hash_api_key(api_key), None)
+
 class AuthService:
     """Authentication service for users and API keys"""
     
@@ -106,54 +152,121 @@ class AuthService:
     
     @staticmethod
     async def authenticate_api_key(api_key: str) -> Optional[str]:
-        """Authenticate node using API key"""
+        """Authenticate node using API key
+
+        Two-tier cache: in-process LRU first (no network hop), then Redis,
+        then the static key table as fallback
+        """
         try:
-            # First check Redis cache if available
+            # Tier 1: in-process LRU
+            node_id = _api_key_cache_get(api_key)
+            if node_id:
+                return node_id
+
+            # Tier 2: Redis cache if available
             if redis_manager:
                 node_id = await redis_manager.get_node_by_api_key(api_key)
                 if node_id:
+                    _api_key_cache_put(api_key, node_id)
                     return node_id
-            
+
             # Check static API keys (fallback)
             if api_key in NODE_API_KEYS:
                 node_id = NODE_API_KEYS[api_key]
                 # Cache the result if Redis is available
                 if redis_manager:
                     await redis_manager.cache_api_key(api_key, node_id)
+                _api_key_cache_put(api_key, node_id)
                 return node_id
-            
+
             return None
-            
+
         except Exception as e:
             logger.error(f"API key authentication failed: {str(e)}")
             return None
-    
+
     @staticmethod
     def authenticate_api_key_sync(api_key: str) -> Optional[str]:
-        """Synchronous version of API key authentication for CoAP server"""
+        """Synchronous version of API key authentication for CoAP server
+
+        Must never block the event loop, so it only touches the in-process
+        LRU and the static key table - no Redis or database calls
+        """
         try:
+            # Tier 1: in-process LRU (populated by the async path too)
+            node_id = _api_key_cache_get(api_key)
+            if node_id:
+                return node_id
+
             # Check static API keys (synchronous fallback)
             if api_key in NODE_API_KEYS:
                 node_id = NODE_API_KEYS[api_key]
+                _api_key_cache_put(api_key, node_id)
                 return node_id
-            
+
             return None
-            
+
         except Exception as e:
             logger.error(f"Sync API key authentication failed: {str(e)}")
             return None
 
+def _user_from_claims(claims: Dict[str, Any]) -> User:
+    """Rebuild a detached User from cached claims - never touches the DB"""
+    def _parse_dt(value):
+        if not value:
+            return None
+        try:
+            return datetime.fromisoformat(value)
+        except (TypeError, ValueError):
+            return None
+
+    return User(
+        user_id=claims.get("user_id"),
+        username=claims.get("username"),
+        email=claims.get("email"),
+        role=claims.get("role"),
+        is_active=claims.get("is_active", True),
+        last_login=_parse_dt(claims.get("last_login")),
+        created_at=_parse_dt(claims.get("created_at"))
+    )
+
+
+def _claims_from_user(user: User) -> Dict[str, Any]:
+    """Serialize the identity fields requests actually need"""
+    return {
+        "user_id": str(user.user_id),
+        "username": user.username,
+        "email": user.email,
+        "role": user.role.value if hasattr(user.role, 'value') else user.role,
+        "is_active": user.is_active,
+        "last_login": user.last_login.isoformat() if user.last_login else None,
+        "created_at": user.created_at.isoformat() if user.created_at else None
+    }
+
+
 # Dependency functions
 async def get_current_user(
     credentials: HTTPAuthorizationCredentials = Security(security),
     db: AsyncSession = Depends(get_db)
 ) -> User:
-    """Get current authenticated user from JWT token"""
+    """Get current authenticated user from JWT token
+
+    Resolved claims are cached in Redis keyed by token hash, so repeat
+    requests with the same token skip the per-request User row lookup
+    entirely. The cache is revoked on logout and on role/status changes
+    (RedisManager.invalidate_user_sessions) and expires on its own TTL.
+    """
     try:
         # Extract token from credentials
         token = credentials.credentials
-        
-        # Check Redis session first if available
+
+        # Tier 1: resolved claims cache - no database round trip
+        if redis_manager:
+            claims = await redis_manager.get_user_claims(token)
+            if claims and claims.get("is_active", True):
+                return _user_from_claims(claims)
+
+        # Tier 2: Redis session store
         if redis_manager:
             session_data = await redis_manager.get_session(token)
             if session_data:
@@ -163,15 +276,16 @@ async def get_current_user(
                     result = await db.execute(query)
                     user = result.scalar_one_or_none()
                     if user:
-                        # Extend session
+                        # Extend session and prime the claims cache
                         await redis_manager.update_session(token, session_data)
+                        await redis_manager.cache_user_claims(token, _claims_from_user(user))
                         return user
-        
+
         # Verify JWT token
         payload = AuthService.verify_token(token)
         username: str = payload.get("sub")
         user_id: str = payload.get("user_id")
-        
+
         if username is None or user_id is None:
             raise HTTPException(
                 status_code=status.HTTP_401_UNAUTHORIZED,
@@ -180,9 +294,11 @@ async def get_current_user(
                     "message": "Token payload invalid"
                 }
             )
-        
+
         # Get user from database
-        user = db.query(User).filter(User.user_id == user_id, User.is_active == True).first()
+        query = select(User).where(User.user_id == user_id, User.is_active == True)
+        result = await db.execute(query)
+        user = result.scalar_one_or_none()
         if user is None:
             raise HTTPException(
                 status_code=status.HTTP_401_UNAUTHORIZED,
@@ -191,9 +307,13 @@ async def get_current_user(
                     "message": "User not found or inactive"
                 }
             )
-        
+
+        # Prime the claims cache for the next requests with this token
+        if redis_manager:
+            await redis_manager.cache_user_claims(token, _claims_from_user(user))
+
         return user
-        
+
     except HTTPException:
         raise
     except Exception as e:
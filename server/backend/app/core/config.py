@@ -34,7 +34,22 @@ class Settings(BaseSettings):
     def async_database_url(self) -> str:
         """Generate asynchronous database URL"""
         return f"postgresql+asyncpg://{self.POSTGRES_USER}:{self.POSTGRES_PASSWORD}@{self.POSTGRES_HOST}:{self.POSTGRES_PORT}/{self.POSTGRES_DB}"
-    
+
+    # Read Replica Configuration (optional - reads fall back to the primary)
+    READ_REPLICA_HOST: str = ""
+    READ_REPLICA_PORT: int = 5432
+
+    # asyncpg per-connection prepared-statement cache; ingest statements are
+    # identical millions of times a day so a large cache pays for itself
+    DB_STATEMENT_CACHE_SIZE: int = 512
+
+    @property
+    def async_read_database_url(self) -> str:
+        """Async database URL for read traffic (replica if configured)"""
+        host = self.READ_REPLICA_HOST or self.POSTGRES_HOST
+        port = self.READ_REPLICA_PORT if self.READ_REPLICA_HOST else self.POSTGRES_PORT
+        return f"postgresql+asyncpg://{self.POSTGRES_USER}:{self.POSTGRES_PASSWORD}@{host}:{port}/{self.POSTGRES_DB}"
+
     # TimescaleDB Configuration
     TIMESCALEDB_ENABLED: bool = True
     TIMESCALE_CHUNK_TIME_INTERVAL: str = "1d"
@@ -53,6 +68,32 @@ class Settings(BaseSettings):
     API_KEY_CACHE_TTL: int = 300  # 5 minutes
     SESSION_TTL: int = 86400  # 24 hours
     
+    # Fast-start Configuration (rolling deploys)
+    # When the schema-version marker in system_config matches, startup skips
+    # the per-boot schema probes and defers Redis warm-up to the background,
+    # so ingest comes back in ~2s instead of ~20s after a container restart
+    FAST_START: bool = False
+
+    # CoAP DTLS Configuration (PSK derived from node API keys)
+    COAP_DTLS_ENABLED: bool = False
+    COAP_DTLS_PORT: int = 5684
+
+    # CoAP Ingest Buffer Configuration (write-behind batching)
+    INGEST_BUFFER_ENABLED: bool = True
+    INGEST_BUFFER_MAX_ROWS: int = 500
+    INGEST_BUFFER_MAX_AGE_MS: int = 250
+    INGEST_BUFFER_MAX_PENDING: int = 50000
+
+    # Zone Rollup Configuration (incremental zone_aggregates maintenance)
+    ZONE_ROLLUP_ENABLED: bool = True
+    ZONE_ROLLUP_INTERVAL_SECONDS: int = 300
+    ZONE_ROLLUP_BUCKET_MINUTES: int = 5
+    # How far behind the high-water mark each cycle re-folds, so readings
+    # that arrive with old timestamps (batch backfills, firmware replays)
+    # are still counted. Must stay well inside the zone_aggregates
+    # compression window (7 days)
+    ZONE_ROLLUP_LOOKBACK_MINUTES: int = 120
+
     # Rate Limiting Configuration
     RATE_LIMIT_ENABLED: bool = True
     DEFAULT_RATE_LIMIT: int = 120  # requests per minute
@@ -74,6 +115,9 @@ class Settings(BaseSettings):
     # Node Configuration
     NODE_HEARTBEAT_TIMEOUT_MINUTES: int = 5
     NODE_OFFLINE_THRESHOLD_MINUTES: int = 10
+    # Redis holds live heartbeat state; the hypertable only gets a row on
+    # status change or at this snapshot cadence
+    HEARTBEAT_SNAPSHOT_INTERVAL_MINUTES: int = 15
     
     # Data Retention Configuration
     SENSOR_DATA_RETENTION_DAYS: int = 365
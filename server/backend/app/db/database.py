@@ -7,16 +7,26 @@ from sqlalchemy import create_engine, text
 from sqlalchemy.ext.asyncio import create_async_engine, AsyncSession, async_sessionmaker
 from sqlalchemy.orm import sessionmaker, Session
 from sqlalchemy.pool import QueuePool
+import json
 import logging
+import time
 from typing import AsyncGenerator, Generator
 from contextlib import asynccontextmanager
 
 from app.core.config import get_settings
 from app.models.models import Base
+from app.utils.metrics import DB_SESSION_WAIT_SECONDS
 
 logger = logging.getLogger(__name__)
 settings = get_settings()
 
+# Bump when the numbered migrations in server/database/sql change. A matching
+# marker in greenhouse.system_config lets FAST_START boots skip the startup
+# probe queries in init_db() - a schema change invalidates the marker and the
+# next boot runs the full checks again
+SCHEMA_VERSION = 11
+SCHEMA_VERSION_KEY = "schema_version"
+
 # Synchronous database engine
 engine = create_engine(
     settings.database_url,
@@ -28,7 +38,7 @@ engine = create_engine(
     echo=settings.DEBUG
 )
 
-# Asynchronous database engine
+# Asynchronous database engine (write pool - ingest and mutations)
 async_engine = create_async_engine(
     settings.async_database_url,
     poolclass=QueuePool,
@@ -36,7 +46,23 @@ async_engine = create_async_engine(
     max_overflow=30,
     pool_pre_ping=True,
     pool_recycle=3600,
-    echo=settings.DEBUG
+    echo=settings.DEBUG,
+    connect_args={"statement_cache_size": settings.DB_STATEMENT_CACHE_SIZE}
+)
+
+# Asynchronous read engine - analytics and history queries go here so long
+# scans cannot exhaust the pool the CoAP ingest path depends on. Points at
+# the read replica when READ_REPLICA_HOST is set, otherwise the primary
+# (still a separate pool, so the isolation holds either way).
+async_read_engine = create_async_engine(
+    settings.async_read_database_url,
+    poolclass=QueuePool,
+    pool_size=20,
+    max_overflow=30,
+    pool_pre_ping=True,
+    pool_recycle=3600,
+    echo=settings.DEBUG,
+    connect_args={"statement_cache_size": settings.DB_STATEMENT_CACHE_SIZE}
 )
 
 # Session makers
@@ -52,10 +78,53 @@ AsyncSessionLocal = async_sessionmaker(
     expire_on_commit=False
 )
 
+AsyncReadSessionLocal = async_sessionmaker(
+    async_read_engine,
+    class_=AsyncSession,
+    expire_on_commit=False
+)
+
+
+async def check_schema_version() -> bool:
+    """Single round-trip check of the schema-version marker"""
+    try:
+        async with async_engine.begin() as conn:
+            result = await conn.execute(
+                text("SELECT config_value->>'version' FROM greenhouse.system_config WHERE config_key = :key"),
+                {"key": SCHEMA_VERSION_KEY}
+            )
+            return result.scalar() == str(SCHEMA_VERSION)
+    except Exception as e:
+        logger.warning(f"Schema version check failed: {e}")
+        return False
+
+
+async def store_schema_version():
+    """Record the verified schema version so later boots can fast-start"""
+    try:
+        async with async_engine.begin() as conn:
+            await conn.execute(
+                text("""
+                    INSERT INTO greenhouse.system_config (config_key, config_value, description)
+                    VALUES (:key, :value, 'Schema version marker for fast-start boots')
+                    ON CONFLICT (config_key) DO UPDATE
+                    SET config_value = EXCLUDED.config_value, updated_at = NOW()
+                """),
+                {"key": SCHEMA_VERSION_KEY, "value": json.dumps({"version": str(SCHEMA_VERSION)})}
+            )
+    except Exception as e:
+        logger.warning(f"Could not store schema version marker: {e}")
+
 
 async def init_db():
     """Initialize database connection and verify TimescaleDB"""
     try:
+        # Fast-start boots skip the probes below when the schema marker
+        # matches - one query instead of half a dozen sequential transactions
+        if settings.FAST_START and await check_schema_version():
+            logger.info(f"Fast start: schema version {SCHEMA_VERSION} verified, skipping startup probes")
+            return
+
         # Test basic PostgreSQL connection first
         async with async_engine.begin() as conn:
             result = await conn.execute(text("SELECT version()"))
@@ -114,14 +183,40 @@ async def init_db():
 
         logger.info("Database initialization completed successfully")
 
+        # All probes passed - stamp the marker so the next boot can fast-start
+        await store_schema_version()
+
     except Exception as e:
         logger.error(f"Database initialization failed: {str(e)}")
         raise
 
 
+async def _observe_connection_wait(session: AsyncSession) -> None:
+    """Force the lazy pool checkout now and record how long it blocked.
+
+    Session construction never touches the pool - the connection is only
+    acquired on first execute - so timing the constructor observes ~0 even
+    with the pool exhausted. Acquiring the connection eagerly here makes
+    the histogram the pool-saturation signal it is meant to be.
+    """
+    wait_started = time.monotonic()
+    await session.connection()
+    DB_SESSION_WAIT_SECONDS.observe(time.monotonic() - wait_started)
+
+
 async def get_db() -> AsyncGenerator[AsyncSession, None]:
     """Dependency to get asynchronous database session"""
     async with AsyncSessionLocal() as session:
+        await _observe_connection_wait(session)
+        try:
+            yield session
+        finally:
+            await session.close()
+
+
+async def get_read_db() -> AsyncGenerator[AsyncSession, None]:
+    """Dependency to get a session from the read pool"""
+    async with AsyncReadSessionLocal() as session:
         try:
             yield session
         finally:
@@ -140,6 +235,7 @@ def get_sync_db() -> Generator[Session, None, None]:
 async def get_async_db() -> AsyncGenerator[AsyncSession, None]:
     """Dependency to get asynchronous database session"""
     async with AsyncSessionLocal() as session:
+        await _observe_connection_wait(session)
         try:
             yield session
         finally:
@@ -150,6 +246,7 @@ async def get_async_db() -> AsyncGenerator[AsyncSession, None]:
 async def get_db_session() -> AsyncSession:
     """Context manager for database session"""
     async with AsyncSessionLocal() as session:
+        await _observe_connection_wait(session)
         try:
             yield session
         except Exception:
@@ -321,11 +418,15 @@ async def close_db():
     try:
         logger.info("Closing database connections...")
 
-        # Close async engine
+        # Close async engines
         if async_engine:
             await async_engine.dispose()
             logger.info("Async database engine closed")
 
+        if async_read_engine:
+            await async_read_engine.dispose()
+            logger.info("Async read database engine closed")
+
         # Close sync engine
         if engine:
             engine.dispose()
@@ -353,6 +454,7 @@ async def test_db_connection():
 async def get_db_session() -> AsyncGenerator[AsyncSession, None]:
     """Get database session for dependency injection"""
     async with AsyncSessionLocal() as session:
+        await _observe_connection_wait(session)
         try:
             yield session
             await session.commit()
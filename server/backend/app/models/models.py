@@ -268,6 +268,20 @@ class SensorReading(Base):
     quality = Column(Enum(DataQuality, name="data_quality", schema="timeseries"), default=DataQuality.good, index=True)
     meta_data = Column("metadata", JSON, default={})
 
+class LatestReading(Base):
+    """Current value per sensor, upserted by the ingest path"""
+    __tablename__ = "latest_readings"
+    __table_args__ = {"schema": "timeseries"}
+
+    sensor_id = Column(UUID(as_uuid=True), primary_key=True)
+    time = Column(DateTime(timezone=True), nullable=False)
+    node_id = Column(String(50), nullable=False, index=True)
+    zone_id = Column(String(10), index=True)
+    sensor_type = Column(Enum(SensorType, name="sensor_type", schema="greenhouse"), nullable=False)
+    value = Column(Numeric(10, 4), nullable=False)
+    unit = Column(String(20), nullable=False)
+    quality = Column(Enum(DataQuality, name="data_quality", schema="timeseries"), default=DataQuality.good)
+
 class ActuatorEvent(Base):
     """Control commands and state change history"""
     __tablename__ = "actuator_events"
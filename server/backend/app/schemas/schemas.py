@@ -123,6 +123,17 @@ class NodeStats(BaseModel):
     sensor_count: int
     actuator_count: int
 
+# OTA rollout schemas
+class OTARolloutCreate(BaseModel):
+    version: str = Field(..., max_length=50)
+    delta_from: Optional[str] = Field(None, max_length=50)
+    image_url: str
+    image_sha256: str = Field(..., min_length=64, max_length=64)
+    image_size_bytes: Optional[int] = Field(None, gt=0)
+    patch_url: Optional[str] = None
+    patch_sha256: Optional[str] = Field(None, min_length=64, max_length=64)
+    patch_size_bytes: Optional[int] = Field(None, gt=0)
+
 # Zone schemas
 class ZoneCreate(BaseModel):
     name: str = Field(..., min_length=2, max_length=100)
@@ -287,6 +298,7 @@ class ActuatorCommandCreate(BaseModel):
     value: Optional[float] = None
     duration_minutes: Optional[int] = Field(None, gt=0)
     timestamp: Optional[datetime] = None
+    priority: Optional[str] = Field(None, pattern="^(emergency|high|normal)$")
 
 class ActuatorCommandResponse(BaseSchema):
     command_id: str
@@ -377,6 +389,12 @@ class PaginationParams(BaseModel):
     page: int = Field(1, ge=1)
     size: int = Field(20, ge=1, le=100)
 
+class CursorPaginatedResponse(BaseModel):
+    """Keyset pagination: deep pages cost the same as page one"""
+    items: List[Any]
+    limit: int
+    next_cursor: Optional[str] = None
+
 class PaginatedResponse(BaseModel):
     items: List[Any]
     total: int
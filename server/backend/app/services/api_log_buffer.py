@@ -0,0 +1,137 @@
+"""
+Smart Greenhouse IoT System - Buffered API Audit Logger
+Batches monitoring.api_logs writes off the request path
+"""
+
+import asyncio
+import logging
+from collections import deque
+from datetime import datetime
+from typing import Any, Dict, Optional
+
+from sqlalchemy import insert
+
+from app.db.database import AsyncSessionLocal
+from app.models.models import APILog
+from app.services.base_service import BaseService
+
+logger = logging.getLogger(__name__)
+
+
+class APILogBuffer(BaseService):
+    """Fire-and-forget audit log buffer.
+
+    The HTTP middleware appends one record per request to an in-memory
+    ring and returns immediately; a background task flushes batches into
+    monitoring.api_logs. Under pressure the oldest records are dropped -
+    losing audit rows is preferable to slowing every API call down.
+    """
+
+    MAX_BATCH_ROWS = 100
+    MAX_AGE_SECONDS = 2.0
+    MAX_PENDING = 10000
+
+    def __init__(self):
+        super().__init__()
+        self._ring: deque = deque(maxlen=self.MAX_PENDING)
+        self._flush_task = None
+        self._running = False
+
+        self.total_records = 0
+        self.total_flushed = 0
+        self.total_dropped = 0
+        self.failed_flushes = 0
+
+    async def start(self):
+        """Start the background flusher task"""
+        if self._running:
+            return
+        self._running = True
+        self._flush_task = asyncio.create_task(self._flush_loop())
+        logger.info("🚀 API log buffer started")
+
+    async def stop(self):
+        """Stop the flusher, draining anything still buffered"""
+        self._running = False
+        if self._flush_task:
+            await self._flush_task
+            self._flush_task = None
+        if self._ring:
+            await self._flush_once()
+        logger.info("🛑 API log buffer stopped")
+
+    def record(
+        self,
+        endpoint: str,
+        method: str,
+        status_code: int,
+        response_time_ms: int,
+        node_id: Optional[str] = None,
+        user_id: Optional[str] = None,
+        ip_address: Optional[str] = None,
+        user_agent: Optional[str] = None,
+        error_message: Optional[str] = None
+    ) -> None:
+        """Append one audit record; never blocks the request path"""
+        if len(self._ring) == self._ring.maxlen:
+            self.total_dropped += 1
+        self._ring.append({
+            "timestamp": datetime.utcnow(),
+            "endpoint": endpoint,
+            "method": method,
+            "status_code": status_code,
+            "response_time_ms": response_time_ms,
+            "node_id": node_id,
+            "user_id": user_id,
+            "ip_address": ip_address,
+            "user_agent": user_agent,
+            "error_message": error_message
+        })
+        self.total_records += 1
+
+    def stats(self) -> Dict[str, Any]:
+        """Buffer depth and flush counters for monitoring"""
+        return {
+            "pending": len(self._ring),
+            "max_pending": self.MAX_PENDING,
+            "total_records": self.total_records,
+            "total_flushed": self.total_flushed,
+            "total_dropped": self.total_dropped,
+            "failed_flushes": self.failed_flushes,
+        }
+
+    async def health_check(self) -> Dict[str, Any]:
+        health = await super().health_check()
+        health.update(self.stats())
+        return health
+
+    async def _flush_loop(self):
+        """Flush batches on a size-or-age cadence"""
+        while self._running:
+            await asyncio.sleep(self.MAX_AGE_SECONDS)
+            if self._ring:
+                await self._flush_once()
+
+    async def _flush_once(self):
+        """Write up to MAX_BATCH_ROWS records with one multi-row insert"""
+        while self._ring:
+            batch = []
+            while self._ring and len(batch) < self.MAX_BATCH_ROWS:
+                batch.append(self._ring.popleft())
+
+            try:
+                async with AsyncSessionLocal() as session:
+                    await session.execute(insert(APILog), batch)
+                    await session.commit()
+                self.total_flushed += len(batch)
+            except Exception as e:
+                self.failed_flushes += 1
+                logger.error(f"💥 API log flush failed for {len(batch)} records: {str(e)}")
+                # Audit logs are best-effort: drop the failed batch rather
+                # than requeueing it against a struggling database
+                self.total_dropped += len(batch)
+                return
+
+
+# Global API log buffer instance
+api_log_buffer = APILogBuffer()
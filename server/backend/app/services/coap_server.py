@@ -4,6 +4,8 @@ Handles CoAP requests for sensor data submission
 """
 
 import asyncio
+import hashlib
+import hmac
 import logging
 import json
 import time
@@ -13,14 +15,81 @@ import aiocoap.resource as resource
 import aiocoap
 from aiocoap import Context, Message, Code
 
+# CBOR support (conditional - constrained nodes may send binary payloads)
+try:
+    import cbor2
+    CBOR_AVAILABLE = True
+except ImportError:
+    CBOR_AVAILABLE = False
+    logging.warning("cbor2 not available - CBOR sensor payloads will be rejected")
+
 from app.db.database import get_db_session
 from app.core.auth import verify_api_key_sync
+from app.core.config import get_settings, NODE_API_KEYS
 from app.models.models import Node, Sensor, SensorReading, DataQuality
 from app.services.base_service import BaseService
+from app.services.command_dispatch import command_dispatch
+from app.services.ingest_buffer import ingest_buffer, upsert_latest_readings
+from app.services.telemetry_stream import telemetry_stream
+from app.utils.metrics import COAP_REQUESTS_TOTAL, COAP_PAYLOAD_PARSE_SECONDS
 from sqlalchemy import select, and_
 from sqlalchemy.ext.asyncio import AsyncSession
 
 logger = logging.getLogger(__name__)
+settings = get_settings()
+
+# CoAP content-format numbers (RFC 7252 / RFC 8949)
+CONTENT_FORMAT_JSON = 50   # application/json
+CONTENT_FORMAT_CBOR = 60   # application/cbor
+
+# Fixed positional schema for CBOR sensor payloads.
+# Nodes send a CBOR array with these slots (trailing nulls may be omitted),
+# which avoids string keys on the wire and dict churn on the server.
+CBOR_PAYLOAD_FIELDS = (
+    "node_id",
+    "api_key",
+    "zone_id",
+    "timestamp",            # epoch seconds (int/float) or ISO string
+    "temperature",
+    "humidity",
+    "soil_moisture",
+    "light",
+    "ph",
+    "ec",
+    "battery_percentage",
+    "signal_strength",
+    "voltage",
+)
+
+# Packed delta frames: one CBOR array per sampling cycle, delta-encoded
+# against the node's previous cycle. Slot 0 is an integer frame marker
+# (a plain positional array always starts with the node_id string, so the
+# formats cannot collide):
+#   [0, node_id, api_key, zone_id, timestamp, <numeric slots...>]   full frame
+#   [1, bitmask, <centi-unit deltas for each set bit, LSB first>]   delta frame
+# Delta frames carry auth in the query string, omit the timestamp (server
+# time is used) and scale deltas by 100 so they stay small CBOR integers.
+DELTA_FRAME_FULL = 0
+DELTA_FRAME_DELTA = 1
+DELTA_SCALE = 100.0
+CBOR_DELTA_FIELDS = CBOR_PAYLOAD_FIELDS[4:]   # the numeric sensor slots
+
+
+class DeltaResyncRequired(Exception):
+    """Raised when a delta frame arrives without a cached base cycle"""
+    pass
+
+# DTLS pre-shared keys are derived from the node API keys with HKDF-SHA256
+# so no second secret has to be provisioned on the nodes. The firmware runs
+# the same two lines over its stored API key.
+DTLS_PSK_INFO = b"greenhouse-coap-dtls-v1"
+
+
+def derive_dtls_psk(api_key: str) -> bytes:
+    """HKDF-SHA256 (extract + single expand block) of a node API key"""
+    prk = hmac.new(b"", api_key.encode('utf-8'), hashlib.sha256).digest()
+    return hmac.new(prk, DTLS_PSK_INFO + b"\x01", hashlib.sha256).digest()
+
 
 # Rate limiting for protocol error warnings
 class RateLimitedLogger:
@@ -99,7 +168,9 @@ class SensorDataResource(resource.Resource):
     def __init__(self):
         super().__init__()
         self.content_format = 50  # application/json
-    
+        # Last absolute sensor values per node, the base for delta frames
+        self._last_cycle: Dict[str, Dict[str, float]] = {}
+
     def _log_request_details(self, request, method="UNKNOWN"):
         """Log comprehensive request details for matched requests"""
         try:
@@ -181,7 +252,15 @@ class SensorDataResource(resource.Resource):
                     "POST /": "Root endpoint"
                 },
                 "auth": "Use query parameters: ?api_key=KEY&node_id=NODE_ID",
-                "payload": "JSON with sensor values: {\"temperature\":22.5,\"humidity\":65.0}"
+                "payload": "JSON with sensor values: {\"temperature\":22.5,\"humidity\":65.0}",
+                "content_formats": {
+                    "50": "application/json (default)",
+                    "60": "application/cbor - fixed array schema: " + ", ".join(CBOR_PAYLOAD_FIELDS)
+                },
+                "packed_frames": {
+                    "full": "[0, <positional slots...>] - resets the delta base",
+                    "delta": "[1, bitmask, <centi-unit deltas>] - against previous cycle; 4.00 'resync' means send a full frame"
+                }
             }
             
             response_payload = json.dumps(info, indent=2).encode('utf-8')
@@ -233,31 +312,61 @@ class SensorDataResource(resource.Resource):
                 logger.warning(f"⚠️ Error parsing query parameters: {query_error}")
                 # Continue without query params
             
-            # Parse JSON payload with enhanced error handling
-            try:
-                if not request.payload:
-                    logger.warning(f"⚠️ Empty payload received from {client_addr}")
-                    return Message(code=Code.BAD_REQUEST, payload=b"Empty payload")
-                
-                # Attempt to decode payload as UTF-8
+            # Parse payload - content format negotiated via the Content-Format option
+            if not request.payload:
+                logger.warning(f"⚠️ Empty payload received from {client_addr}")
+                COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                return Message(code=Code.BAD_REQUEST, payload=b"Empty payload")
+
+            content_format = getattr(request.opt, 'content_format', None)
+
+            # Delta-base updates produced while decoding are staged here and
+            # only committed to _last_cycle after authentication succeeds, so
+            # an unauthenticated frame cannot poison another node's base
+            pending_cycles: Dict[str, Dict[str, float]] = {}
+
+            if content_format == CONTENT_FORMAT_CBOR:
+                # Binary CBOR path - fixed positional schema, no text parsing
+                parse_started = time.monotonic()
                 try:
-                    payload_str = request.payload.decode('utf-8')
-                except UnicodeDecodeError as unicode_error:
-                    logger.error(f"❌ Invalid UTF-8 payload from {client_addr}: {unicode_error}")
-                    logger.error(f"🔍 Raw payload bytes: {request.payload[:50]}...")  # Log first 50 bytes
-                    return Message(code=Code.BAD_REQUEST, payload=b"Invalid UTF-8 encoding in payload")
-                
-                # Parse JSON
-                payload = json.loads(payload_str)
-                logger.info(f"📦 CoAP payload received: {json.dumps(payload, indent=2)}")
-                
-            except json.JSONDecodeError as json_error:
-                logger.error(f"❌ Invalid JSON payload from {client_addr}: {json_error}")
-                logger.error(f"🔍 Payload content: {request.payload.decode('utf-8', errors='replace')[:200]}...")
-                return Message(code=Code.BAD_REQUEST, payload=b"Invalid JSON payload")
-            except Exception as payload_error:
-                logger.error(f"❌ Unexpected payload error from {client_addr}: {payload_error}")
-                return Message(code=Code.BAD_REQUEST, payload=b"Payload processing error")
+                    payload = self._decode_cbor_payload(request.payload, client_addr, node_id, pending_cycles)
+                except DeltaResyncRequired:
+                    # No cached base (server restart or first contact) - tell
+                    # the node to resend the cycle as a full frame
+                    logger.info(f"🔁 Delta frame without base from {client_addr} - requesting resync")
+                    COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                    return Message(code=Code.BAD_REQUEST, payload=b"resync")
+                COAP_PAYLOAD_PARSE_SECONDS.labels(format="cbor").observe(time.monotonic() - parse_started)
+                if payload is None:
+                    COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                    return Message(code=Code.BAD_REQUEST, payload=b"Invalid CBOR payload")
+            else:
+                # Default JSON path (content format 50 or unspecified)
+                parse_started = time.monotonic()
+                try:
+                    # Attempt to decode payload as UTF-8
+                    try:
+                        payload_str = request.payload.decode('utf-8')
+                    except UnicodeDecodeError as unicode_error:
+                        logger.error(f"❌ Invalid UTF-8 payload from {client_addr}: {unicode_error}")
+                        logger.error(f"🔍 Raw payload bytes: {request.payload[:50]}...")  # Log first 50 bytes
+                        COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                        return Message(code=Code.BAD_REQUEST, payload=b"Invalid UTF-8 encoding in payload")
+
+                    # Parse JSON
+                    payload = json.loads(payload_str)
+                    COAP_PAYLOAD_PARSE_SECONDS.labels(format="json").observe(time.monotonic() - parse_started)
+                    logger.info(f"📦 CoAP payload received: {json.dumps(payload, indent=2)}")
+
+                except json.JSONDecodeError as json_error:
+                    logger.error(f"❌ Invalid JSON payload from {client_addr}: {json_error}")
+                    logger.error(f"🔍 Payload content: {request.payload.decode('utf-8', errors='replace')[:200]}...")
+                    COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                    return Message(code=Code.BAD_REQUEST, payload=b"Invalid JSON payload")
+                except Exception as payload_error:
+                    logger.error(f"❌ Unexpected payload error from {client_addr}: {payload_error}")
+                    COAP_REQUESTS_TOTAL.labels(outcome="bad_request").inc()
+                    return Message(code=Code.BAD_REQUEST, payload=b"Payload processing error")
             
             # Get API key and node_id from payload if not in query
             if not api_key:
@@ -269,6 +378,7 @@ class SensorDataResource(resource.Resource):
             if not api_key or not node_id:
                 logger.warning(f"🚫 Missing API key or node ID in CoAP request from {client_addr}")
                 logger.info(f"💡 Hint: For clean sensor payloads, use query parameters: /sensor/send-data?api_key=KEY&node_id=NODE")
+                COAP_REQUESTS_TOTAL.labels(outcome="unauthorized").inc()
                 return Message(code=Code.UNAUTHORIZED, payload=b"Missing API key or node ID. Use query parameters: ?api_key=KEY&node_id=NODE")
             
             # Verify API key and get node
@@ -277,8 +387,14 @@ class SensorDataResource(resource.Resource):
                 node = await self.verify_node_auth(db, api_key, node_id)
                 if not node:
                     logger.warning(f"❌ Authentication failed for node: {node_id}")
+                    COAP_REQUESTS_TOTAL.labels(outcome="unauthorized").inc()
                     return Message(code=Code.UNAUTHORIZED, payload=b"Invalid API key or node ID")
-                
+
+                # Sender proved it owns this node_id - commit its staged
+                # delta base (and only its own, whatever the payload claimed)
+                if node.node_id in pending_cycles:
+                    self._last_cycle[node.node_id] = pending_cycles[node.node_id]
+
                 # Process sensor data
                 logger.info(f"🔄 Processing sensor data for node: {node_id}")
                 result = await self.process_sensor_data(db, node, payload)
@@ -294,6 +410,7 @@ class SensorDataResource(resource.Resource):
                     logger.info(f"📤 Response Size: {len(response_payload)} bytes")
                     logger.info(f"📤 Response Code: 2.01 Created")
                     logger.info(f"📤 Response Content: {response_payload.decode('utf-8')}")
+                    COAP_REQUESTS_TOTAL.labels(outcome="created").inc()
                     return Message(code=Code.CREATED, payload=response_payload)
                 else:
                     logger.error(f"❌ CoAP ERROR: {result['message']} for node {node_id}")
@@ -304,8 +421,9 @@ class SensorDataResource(resource.Resource):
                     logger.info(f"📤 Error Response Size: {len(error_payload)} bytes")
                     logger.info(f"📤 Error Response Code: 5.00 Internal Server Error")
                     logger.info(f"📤 Error Response Content: {error_payload.decode('utf-8')}")
+                    COAP_REQUESTS_TOTAL.labels(outcome="server_error").inc()
                     return Message(code=Code.INTERNAL_SERVER_ERROR, payload=error_payload)
-                    
+
         except Exception as e:
             logger.error(f"💥 CoAP EXCEPTION: {str(e)} from {client_addr}")
             logger.error(f"🔍 Exception type: {type(e).__name__}")
@@ -323,8 +441,140 @@ class SensorDataResource(resource.Resource):
             logger.info(f"📤 Exception Response Size: {len(error_payload)} bytes")
             logger.info(f"📤 Exception Response Code: 5.00 Internal Server Error")
             logger.info(f"📤 Exception Response Content: {error_payload.decode('utf-8')}")
+            COAP_REQUESTS_TOTAL.labels(outcome="exception").inc()
             return Message(code=Code.INTERNAL_SERVER_ERROR, payload=error_payload)
     
+    def _decode_cbor_payload(self, raw: bytes, client_addr, node_id: Optional[str] = None,
+                             pending: Optional[Dict[str, Dict[str, float]]] = None) -> Optional[Dict[str, Any]]:
+        """Decode a fixed-schema CBOR array into the reading dict used downstream.
+
+        Accepts the positional array schema (CBOR_PAYLOAD_FIELDS), the packed
+        delta-frame format (integer frame marker in slot 0), or a CBOR map
+        with the same string keys as the JSON payload, so nodes can migrate
+        field by field.
+
+        Decoding never touches _last_cycle directly: base updates go into
+        `pending` and the caller commits them once the sender authenticates.
+
+        Raises DeltaResyncRequired when a delta frame arrives for a node with
+        no cached base cycle.
+        """
+        if not CBOR_AVAILABLE:
+            logger.warning(f"⚠️ CBOR payload from {client_addr} but cbor2 is not installed")
+            return None
+
+        try:
+            decoded = cbor2.loads(raw)
+        except Exception as cbor_error:
+            logger.error(f"❌ Invalid CBOR payload from {client_addr}: {cbor_error}")
+            return None
+
+        if isinstance(decoded, (list, tuple)):
+            if decoded and isinstance(decoded[0], int):
+                return self._decode_delta_frame(list(decoded), client_addr, node_id, pending)
+            if len(decoded) > len(CBOR_PAYLOAD_FIELDS):
+                logger.error(f"❌ CBOR array too long from {client_addr}: {len(decoded)} slots")
+                return None
+            payload = {
+                field: value
+                for field, value in zip(CBOR_PAYLOAD_FIELDS, decoded)
+                if value is not None
+            }
+        elif isinstance(decoded, dict):
+            payload = {k: v for k, v in decoded.items() if v is not None}
+        else:
+            logger.error(f"❌ Unexpected CBOR top-level type from {client_addr}: {type(decoded).__name__}")
+            return None
+
+        # Nodes send epoch seconds to save bytes; normalize to the ISO string
+        # process_sensor_data expects
+        timestamp = payload.get('timestamp')
+        if isinstance(timestamp, (int, float)):
+            payload['timestamp'] = datetime.utcfromtimestamp(timestamp).isoformat()
+
+        logger.debug(f"📦 CoAP CBOR payload decoded: {len(payload)} fields from {client_addr}")
+        self._remember_cycle(payload, pending)
+        return payload
+
+    def _decode_delta_frame(self, frame: list, client_addr, node_id: Optional[str],
+                            pending: Optional[Dict[str, Dict[str, float]]] = None) -> Optional[Dict[str, Any]]:
+        """Expand a packed full/delta frame into the standard payload dict.
+
+        Full frames reset the per-node base; delta frames apply centi-unit
+        deltas to it. Either way the expanded payload carries every numeric
+        slot so one radio wakeup still yields a complete cycle of readings.
+        """
+        marker = frame[0]
+
+        if marker == DELTA_FRAME_FULL:
+            values = frame[1:]
+            if len(values) > len(CBOR_PAYLOAD_FIELDS):
+                logger.error(f"❌ Full frame too long from {client_addr}: {len(values)} slots")
+                return None
+            payload = {
+                field: value
+                for field, value in zip(CBOR_PAYLOAD_FIELDS, values)
+                if value is not None
+            }
+            self._remember_cycle(payload, pending)
+            logger.debug(f"📦 Full frame from {client_addr}: base reset staged for node {payload.get('node_id', node_id)}")
+            return payload
+
+        if marker == DELTA_FRAME_DELTA:
+            # Delta frames have no in-payload auth; node_id must come from
+            # the query string, and the base from a previous full frame
+            if not node_id or node_id not in self._last_cycle:
+                raise DeltaResyncRequired()
+            if len(frame) < 2 or not isinstance(frame[1], int):
+                logger.error(f"❌ Delta frame missing bitmask from {client_addr}")
+                return None
+
+            bitmask = frame[1]
+            deltas = frame[2:]
+            base = dict(self._last_cycle[node_id])
+
+            delta_index = 0
+            for bit, field in enumerate(CBOR_DELTA_FIELDS):
+                if not bitmask & (1 << bit):
+                    continue
+                if delta_index >= len(deltas):
+                    logger.error(f"❌ Delta frame truncated from {client_addr}: bitmask {bitmask:#x} needs more slots")
+                    return None
+                previous = base.get(field)
+                if previous is None:
+                    # Node is deltaing a field the base never carried
+                    raise DeltaResyncRequired()
+                base[field] = previous + deltas[delta_index] / DELTA_SCALE
+                delta_index += 1
+
+            if pending is not None:
+                pending[node_id] = base
+            # Unchanged fields are re-emitted so every cycle records a full
+            # set of readings; timestamp defaults to server time downstream
+            payload = {field: value for field, value in base.items() if value is not None}
+            logger.debug(f"📦 Delta frame from {client_addr}: {delta_index} changed / {len(payload)} total fields")
+            return payload
+
+        logger.error(f"❌ Unknown frame marker {marker} from {client_addr}")
+        return None
+
+    def _remember_cycle(self, payload: Dict[str, Any],
+                        pending: Optional[Dict[str, Dict[str, float]]] = None) -> None:
+        """Stage the numeric slots of a cycle as the node's delta base"""
+        payload_node_id = payload.get('node_id')
+        if not payload_node_id or pending is None:
+            return
+        base = {}
+        for field in CBOR_DELTA_FIELDS:
+            value = payload.get(field)
+            if value is not None:
+                try:
+                    base[field] = float(value)
+                except (TypeError, ValueError):
+                    continue
+        if base:
+            pending[payload_node_id] = base
+
     async def verify_node_auth(self, db: AsyncSession, api_key: str, node_id: str) -> Optional[Node]:
         """Verify API key and return node if valid"""
         try:
@@ -365,63 +615,82 @@ class SensorDataResource(resource.Resource):
                 "voltage": data.get("voltage")
             }
             
+            # Resolve all active sensors for the node with one query
+            sensor_query = select(Sensor).where(
+                and_(
+                    Sensor.node_id == node.node_id,
+                    Sensor.is_active == True
+                )
+            )
+            sensor_result = await db.execute(sensor_query)
+            sensors_by_type = {}
+            for sensor in sensor_result.scalars().all():
+                sensors_by_type.setdefault(str(sensor.sensor_type.value if hasattr(sensor.sensor_type, 'value') else sensor.sensor_type), sensor)
+
+            # Determine unit based on sensor type
+            unit_map = {
+                "temperature": "°C",
+                "humidity": "%",
+                "soil_moisture": "%",
+                "light": "lux",
+                "ph": "pH",
+                "ec": "μS/cm",
+                "battery_percentage": "%",
+                "signal_strength": "dBm",
+                "voltage": "V"
+            }
+
+            reading_rows = []
             for sensor_type, value in sensor_mappings.items():
                 if value is not None:
-                    # Find active sensor of this type for the node
-                    sensor_query = select(Sensor).where(
-                        and_(
-                            Sensor.node_id == node.node_id,
-                            Sensor.sensor_type == sensor_type,
-                            Sensor.is_active == True
-                        )
-                    ).limit(1)
-                    
-                    sensor_result = await db.execute(sensor_query)
-                    sensor = sensor_result.scalar_one_or_none()
-                    
+                    sensor = sensors_by_type.get(sensor_type)
                     if sensor:
                         # Apply calibration
                         calibrated_value = (float(value) * float(sensor.calibration_multiplier)) + float(sensor.calibration_offset)
                         logger.debug(f"📈 {sensor_type}: {value} → {calibrated_value} (calibrated)")
-                        
-                        # Determine unit based on sensor type
-                        unit_map = {
-                            "temperature": "°C",
-                            "humidity": "%",
-                            "soil_moisture": "%",
-                            "light": "lux",
-                            "ph": "pH",
-                            "ec": "μS/cm",
-                            "battery_percentage": "%",
-                            "signal_strength": "dBm",
-                            "voltage": "V"
-                        }
-                        
-                        # Create sensor reading
-                        reading = SensorReading(
-                            time=reading_time,
-                            node_id=node.node_id,
-                            zone_id=zone_id or sensor.zone_id,
-                            sensor_id=sensor.sensor_id,
-                            sensor_type=sensor_type,
-                            value=calibrated_value,
-                            unit=unit_map.get(sensor_type, ""),
-                            quality=DataQuality.good,
-                            meta_data=data.get('meta_data', {})
-                        )
-                        
-                        db.add(reading)
+
+                        reading_rows.append({
+                            "time": reading_time,
+                            "node_id": node.node_id,
+                            "zone_id": zone_id or sensor.zone_id,
+                            "sensor_id": sensor.sensor_id,
+                            "sensor_type": sensor_type,
+                            "value": calibrated_value,
+                            "unit": unit_map.get(sensor_type, ""),
+                            "quality": DataQuality.good,
+                            "meta_data": data.get('meta_data', {})
+                        })
                         readings_created += 1
                         logger.debug(f"💾 Created reading: {sensor_type} = {calibrated_value} {unit_map.get(sensor_type, '')}")
                     else:
                         logger.warning(f"⚠️ No active sensor found for type {sensor_type} on node {node.node_id}")
-            
+
             if readings_created > 0:
-                # Update node last_seen timestamp
-                node.last_seen = reading_time
-                await db.commit()
-                logger.info(f"💿 Database commit successful: {readings_created} readings saved for node {node.node_id}")
-                
+                # Fan out to live dashboard streams before persistence
+                for row in reading_rows:
+                    telemetry_stream.publish({
+                        "time": row["time"].isoformat() + "Z",
+                        "node_id": row["node_id"],
+                        "zone_id": row["zone_id"],
+                        "sensor_type": row["sensor_type"],
+                        "value": row["value"],
+                        "unit": row["unit"]
+                    })
+
+                if settings.INGEST_BUFFER_ENABLED:
+                    # Write-behind path: ACK once validated and enqueued,
+                    # the buffer flushes multi-row batches and last_seen
+                    accepted = ingest_buffer.enqueue(reading_rows)
+                    logger.info(f"📥 Enqueued {accepted} readings from node {node.node_id} (queue depth {ingest_buffer.queue_depth})")
+                else:
+                    for row in reading_rows:
+                        db.add(SensorReading(**row))
+                    await upsert_latest_readings(db, reading_rows)
+                    # Update node last_seen timestamp
+                    node.last_seen = reading_time
+                    await db.commit()
+                    logger.info(f"💿 Database commit successful: {readings_created} readings saved for node {node.node_id}")
+
                 return {
                     "success": True,
                     "readings_count": readings_created,
@@ -444,6 +713,76 @@ class SensorDataResource(resource.Resource):
                 "message": f"Error processing sensor data: {str(e)}"
             }
 
+class ActuatorCommandResource(resource.ObservableResource):
+    """CoAP Observe push channel for actuator commands.
+
+    Nodes register once with GET /actuator/commands?api_key=KEY&node_id=NODE
+    plus the Observe option. Whenever the actuators API publishes a command
+    through the dispatcher, every open observation is re-rendered - the
+    observation whose node has pending commands receives them immediately,
+    the rest get an empty notification (cheap at our fleet size). Plain GETs
+    without Observe work too, so polling keeps working as the fallback.
+    """
+
+    def __init__(self):
+        super().__init__()
+        command_dispatch.add_listener(self._on_command)
+
+    def _on_command(self, node_id: str):
+        """Dispatcher callback - wake all observations so the target node drains"""
+        self.updated_state()
+
+    async def render_get(self, request):
+        client_addr = getattr(request, 'remote', 'unknown')
+
+        query_params = {}
+        try:
+            if request.opt.uri_query:
+                for param in request.opt.uri_query:
+                    if '=' in param:
+                        key, value = param.split('=', 1)
+                        query_params[key] = value
+        except (AttributeError, UnicodeDecodeError, ValueError) as query_error:
+            logger.warning(f"⚠️ Error parsing observe query parameters: {query_error}")
+
+        api_key = query_params.get('api_key')
+        node_id = query_params.get('node_id')
+
+        if not api_key or not node_id:
+            logger.warning(f"🚫 Missing API key or node ID in observe request from {client_addr}")
+            return Message(code=Code.UNAUTHORIZED, payload=b"Missing API key or node ID. Use query parameters: ?api_key=KEY&node_id=NODE")
+
+        # Verify API key and node pairing against the database
+        try:
+            async with get_db_session() as db:
+                query = select(Node).where(
+                    and_(
+                        Node.api_key == api_key,
+                        Node.node_id == node_id
+                    )
+                )
+                result = await db.execute(query)
+                node = result.scalar_one_or_none()
+        except Exception as e:
+            logger.error(f"Database error during observe auth: {e}")
+            return Message(code=Code.INTERNAL_SERVER_ERROR, payload=b"Server error")
+
+        if not node:
+            logger.warning(f"❌ Observe authentication failed for node: {node_id}")
+            return Message(code=Code.UNAUTHORIZED, payload=b"Invalid API key or node ID")
+
+        commands = await command_dispatch.drain(node_id)
+        if commands:
+            logger.info(f"📡 Pushing {len(commands)} actuator command(s) to node {node_id}")
+
+        response_payload = json.dumps({
+            "node_id": node_id,
+            "commands": commands,
+            "timestamp": datetime.utcnow().isoformat()
+        }).encode('utf-8')
+        return Message(code=Code.CONTENT, payload=response_payload)
+
+
 class CoAPServerService(BaseService):
     """CoAP Server for IoT device communication"""
     
@@ -452,6 +791,7 @@ class CoAPServerService(BaseService):
         self.host = host
         self.port = port
         self.context = None
+        self.dtls_context = None
         self.server_task = None
         self.log_protocol_errors = log_protocol_errors
     
@@ -473,6 +813,9 @@ class CoAPServerService(BaseService):
             root.add_resource(['sensor'], sensor_resource)
             root.add_resource([''], sensor_resource)  # Root endpoint
             
+            # Observe push channel for actuator commands
+            root.add_resource(['actuator', 'commands'], ActuatorCommandResource())
+
             # Add catch-all resource to log unmatched requests (this helps debug NotFound errors)
             catch_all = CatchAllResource()
             # Common paths that might be requested but not handled
@@ -491,7 +834,45 @@ class CoAPServerService(BaseService):
             # Set up exception handling for the context
             if hasattr(self.context, 'loop'):
                 self.context.loop.set_exception_handler(self._handle_exception)
-            
+
+            # Optional DTLS-PSK listener on the coaps port, sharing the same
+            # resource tree. Nodes authenticate with a PSK derived from their
+            # API key (identity = node_id). Session resumption after deep
+            # sleep currently relies on tinydtls session caching; RFC 9146
+            # connection IDs land once the underlying library exposes them.
+            if settings.COAP_DTLS_ENABLED:
+                try:
+                    self.dtls_context = await Context.create_server_context(
+                        root,
+                        bind=(self.host, settings.COAP_DTLS_PORT),
+                        transports=['tinydtls_server']
+                    )
+                    self.dtls_context.server_credentials.load_from_dict({
+                        f":{node_id}": {
+                            "dtls": {
+                                "psk": {"hex": derive_dtls_psk(api_key).hex()},
+                                "client-identity": {"ascii": node_id}
+                            }
+                        }
+                        for api_key, node_id in NODE_API_KEYS.items()
+                    })
+                    logger.info(f"🔐 CoAP DTLS listener started on {self.host}:{settings.COAP_DTLS_PORT} ({len(NODE_API_KEYS)} PSK identities)")
+                except Exception as dtls_error:
+                    # Plaintext ingest keeps working; DTLS needs the tinydtls
+                    # extra (pip install aiocoap[tinydtls])
+                    self.dtls_context = None
+                    logger.warning(f"⚠️ CoAP DTLS listener failed to start: {dtls_error}")
+
+            # Start write-behind ingest buffer
+            if settings.INGEST_BUFFER_ENABLED:
+                await ingest_buffer.start()
+
+            # Wake observers on commands published by other processes
+            try:
+                await command_dispatch.start_notify_listener()
+            except Exception as notify_error:
+                logger.warning(f"⚠️ Command notify listener failed to start: {notify_error}")
+
             logger.info(f"🚀 CoAP server started on {self.host}:{self.port}")
             logger.info(f"� Log protocol errors: {self.log_protocol_errors}")
             logger.info("�📋 Available endpoints:")
@@ -500,6 +881,7 @@ class CoAPServerService(BaseService):
             logger.info(f"  📨 POST coap://{self.host}:{self.port}/data")
             logger.info(f"  📨 POST coap://{self.host}:{self.port}/sensor")
             logger.info(f"  📨 POST coap://{self.host}:{self.port}/")
+            logger.info(f"  📡 GET  coap://{self.host}:{self.port}/actuator/commands (Observe)")
             logger.info("📋 Catch-all endpoints for debugging:")
             logger.info(f"  🔍 /api, /coap, /sensors, /device, /submit")
             logger.info("📋 All requests will be logged in detail!")
@@ -547,6 +929,13 @@ class CoAPServerService(BaseService):
     
     async def stop(self):
         """Stop the CoAP server"""
+        await command_dispatch.stop_notify_listener()
+        if settings.INGEST_BUFFER_ENABLED:
+            await ingest_buffer.stop()
+        if self.dtls_context:
+            await self.dtls_context.shutdown()
+            self.dtls_context = None
+            logger.info("🛑 CoAP DTLS listener stopped")
         if self.context:
             await self.context.shutdown()
             logger.info("🛑 CoAP server stopped")
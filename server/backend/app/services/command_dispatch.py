@@ -0,0 +1,231 @@
+"""
+Smart Greenhouse IoT System - Actuator Command Dispatch
+Priority queue between the actuators API and the CoAP delivery path
+"""
+
+import asyncio
+import json
+import logging
+import time
+from datetime import datetime
+from typing import Any, Callable, Dict, List, Optional
+
+from app.utils.redis_utils import redis_manager
+from app.utils.metrics import COMMAND_DISPATCH_LATENCY_SECONDS
+
+logger = logging.getLogger(__name__)
+
+# Per-node queue depth; a node that never drains loses its most routine
+# (highest score) commands first
+MAX_PENDING_PER_NODE = 50
+
+# Priority classes, most urgent first. The class is the high-order part of
+# the sorted-set score, so an emergency command always sorts ahead of every
+# routine one no matter how long the routine backlog is
+PRIORITY_CLASSES = {"emergency": 0, "high": 1, "normal": 2}
+DEFAULT_PRIORITY = "normal"
+
+# Abandoned per-node queues expire rather than leak
+QUEUE_TTL_SECONDS = 3600
+
+NOTIFY_CHANNEL = "actuator:command_notify"
+
+
+def _command_score(priority: str, queued_at_ms: int) -> float:
+    """Score = priority class then FIFO within the class"""
+    rank = PRIORITY_CLASSES.get(priority, PRIORITY_CLASSES[DEFAULT_PRIORITY])
+    return rank * 1e13 + queued_at_ms
+
+
+class CommandDispatcher:
+    """Per-node priority queue of actuator commands.
+
+    The actuators API publishes a command dict the moment its
+    ActuatorEvent commits; the CoAP Observe resource drains the per-node
+    queue and pushes it to the node's open observation. Queues live in
+    Redis sorted sets (commands:{node_id}) so the API and the coap_ingest
+    workers share them across processes, with a pub/sub channel waking
+    observers; when Redis is down everything falls back to in-process
+    queues, which still cover single-process deployments. Nodes that are
+    not observing simply keep polling the actuators API - the queue is a
+    latency optimization, not the source of truth (that stays in
+    timeseries.actuator_events).
+    """
+
+    def __init__(self):
+        self._pending: Dict[str, List[Dict[str, Any]]] = {}
+        self._listeners: List[Callable[[str], None]] = []
+        self._notify_task: Optional[asyncio.Task] = None
+        self._seq = 0
+
+        self.total_published = 0
+        self.total_drained = 0
+        self.total_dropped = 0
+
+    async def publish(self, node_id: str, command: Dict[str, Any],
+                      priority: str = DEFAULT_PRIORITY) -> None:
+        """Queue a command for a node and wake its observation, if any"""
+        if priority not in PRIORITY_CLASSES:
+            logger.warning(f"⚠️ Unknown command priority '{priority}' - using {DEFAULT_PRIORITY}")
+            priority = DEFAULT_PRIORITY
+
+        queued_at_ms = int(time.time() * 1000)
+        self._seq += 1
+        entry = {
+            **command,
+            "priority": priority,
+            "queued_at": datetime.utcnow().isoformat() + "Z",
+            "queued_at_ms": queued_at_ms,
+            "seq": self._seq,
+        }
+
+        stored = False
+        if redis_manager.redis:
+            try:
+                key = f"commands:{node_id}"
+                pipe = redis_manager.redis.pipeline()
+                pipe.zadd(key, {json.dumps(entry): _command_score(priority, queued_at_ms)})
+                # Cap the queue keeping the lowest scores (most urgent, oldest)
+                pipe.zremrangebyrank(key, MAX_PENDING_PER_NODE, -1)
+                pipe.expire(key, QUEUE_TTL_SECONDS)
+                pipe.publish(NOTIFY_CHANNEL, node_id)
+                results = await pipe.execute()
+                if results[1]:
+                    self.total_dropped += results[1]
+                    logger.warning(f"⚠️ Command queue full for node {node_id} - dropped {results[1]} routine command(s)")
+                stored = True
+            except Exception as e:
+                logger.warning(f"⚠️ Redis command queue unavailable, using in-process queue: {str(e)}")
+
+        if not stored:
+            queue = self._pending.setdefault(node_id, [])
+            queue.append(entry)
+            if len(queue) > MAX_PENDING_PER_NODE:
+                # Drop the most routine, newest command
+                queue.sort(key=lambda c: _command_score(c["priority"], c["queued_at_ms"]))
+                queue.pop()
+                self.total_dropped += 1
+                logger.warning(f"⚠️ Command queue full for node {node_id} - dropping most routine")
+
+        self.total_published += 1
+        self._notify(node_id)
+
+    async def drain(self, node_id: str) -> List[Dict[str, Any]]:
+        """Take all pending commands for a node, most urgent first"""
+        commands: List[Dict[str, Any]] = []
+
+        if redis_manager.redis:
+            try:
+                key = f"commands:{node_id}"
+                pipe = redis_manager.redis.pipeline(transaction=True)
+                pipe.zrange(key, 0, -1)
+                pipe.delete(key)
+                results = await pipe.execute()
+                commands.extend(json.loads(raw) for raw in results[0])
+            except Exception as e:
+                logger.warning(f"⚠️ Redis command drain failed for node {node_id}: {str(e)}")
+
+        local = self._pending.pop(node_id, None)
+        if local:
+            commands.extend(local)
+
+        if not commands:
+            return []
+
+        commands.sort(key=lambda c: _command_score(c.get("priority", DEFAULT_PRIORITY),
+                                                   c.get("queued_at_ms", 0)))
+        self.total_drained += len(commands)
+
+        # Publish-to-drain latency per priority class (the SLO metric)
+        now_ms = int(time.time() * 1000)
+        for entry in commands:
+            queued_at_ms = entry.pop("queued_at_ms", None)
+            entry.pop("seq", None)
+            if queued_at_ms:
+                COMMAND_DISPATCH_LATENCY_SECONDS.labels(
+                    priority=entry.get("priority", DEFAULT_PRIORITY)
+                ).observe(max(0.0, (now_ms - queued_at_ms) / 1000.0))
+
+        return commands
+
+    async def pending_count(self, node_id: str) -> int:
+        """Commands currently queued for a node"""
+        count = len(self._pending.get(node_id, []))
+        if redis_manager.redis:
+            try:
+                count += await redis_manager.redis.zcard(f"commands:{node_id}")
+            except Exception:
+                pass
+        return count
+
+    def add_listener(self, listener: Callable[[str], None]) -> None:
+        """Register a callback invoked with the node_id on every publish"""
+        self._listeners.append(listener)
+
+    def remove_listener(self, listener: Callable[[str], None]) -> None:
+        """Unregister a publish callback"""
+        if listener in self._listeners:
+            self._listeners.remove(listener)
+
+    def _notify(self, node_id: str) -> None:
+        """Invoke local listeners; remote processes are woken via pub/sub"""
+        for listener in list(self._listeners):
+            try:
+                listener(node_id)
+            except Exception as e:
+                logger.error(f"💥 Command listener failed for node {node_id}: {str(e)}")
+
+    async def start_notify_listener(self) -> None:
+        """Subscribe to the notify channel (run in the CoAP server process)"""
+        if self._notify_task or not redis_manager.redis:
+            return
+        self._notify_task = asyncio.create_task(self._notify_loop())
+        logger.info(f"📡 Command dispatch listening on Redis channel {NOTIFY_CHANNEL}")
+
+    async def stop_notify_listener(self) -> None:
+        """Stop the pub/sub subscription"""
+        if self._notify_task:
+            self._notify_task.cancel()
+            try:
+                await self._notify_task
+            except asyncio.CancelledError:
+                pass
+            self._notify_task = None
+
+    async def _notify_loop(self) -> None:
+        """Forward cross-process publish notifications to local listeners"""
+        pubsub = redis_manager.redis.pubsub()
+        await pubsub.subscribe(NOTIFY_CHANNEL)
+        try:
+            async for message in pubsub.listen():
+                if message.get("type") != "message":
+                    continue
+                node_id = message.get("data")
+                if isinstance(node_id, bytes):
+                    node_id = node_id.decode("utf-8")
+                self._notify(node_id)
+        except asyncio.CancelledError:
+            raise
+        except Exception as e:
+            logger.error(f"💥 Command notify listener failed: {str(e)}")
+        finally:
+            try:
+                await pubsub.close()
+            except Exception:
+                pass
+
+    def stats(self) -> Dict[str, Any]:
+        """Dispatch counters for monitoring (in-process view)"""
+        return {
+            "nodes_with_pending": sum(1 for q in self._pending.values() if q),
+            "total_pending": sum(len(q) for q in self._pending.values()),
+            "total_published": self.total_published,
+            "total_drained": self.total_drained,
+            "total_dropped": self.total_dropped,
+            "listeners": len(self._listeners),
+            "notify_listener_running": self._notify_task is not None,
+        }
+
+
+# Global command dispatcher instance
+command_dispatch = CommandDispatcher()
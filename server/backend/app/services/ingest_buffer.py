@@ -0,0 +1,252 @@
+"""
+Smart Greenhouse IoT System - Write-Behind Sensor Ingest Buffer
+Batches validated CoAP sensor readings into multi-row inserts
+"""
+
+import asyncio
+import logging
+import time
+from collections import deque
+from datetime import datetime
+from typing import Any, Dict, List
+
+from sqlalchemy import insert, update
+from sqlalchemy.dialects.postgresql import insert as pg_insert
+
+from app.core.config import get_settings
+from app.db.database import AsyncSessionLocal
+from app.models.models import LatestReading, Node, SensorReading
+from app.services.base_service import BaseService
+
+logger = logging.getLogger(__name__)
+settings = get_settings()
+
+# Consecutive flush failures tolerated while draining at shutdown before
+# giving up - keeps a dead database from hanging the process exit
+SHUTDOWN_FLUSH_RETRIES = 3
+
+# Columns latest_readings mirrors from a reading row
+_LATEST_COLUMNS = ("sensor_id", "time", "node_id", "zone_id", "sensor_type", "value", "unit", "quality")
+
+
+async def upsert_latest_readings(session, rows: List[Dict[str, Any]]) -> None:
+    """Fold a batch of reading rows into timeseries.latest_readings.
+
+    One upsert per distinct sensor (newest row in the batch wins); the
+    WHERE guard keeps backfill replays from overwriting fresher state.
+    Shared by the ingest buffer flush and the batch submission endpoint so
+    every write path maintains the table.
+    """
+    latest: Dict[Any, Dict[str, Any]] = {}
+    for row in rows:
+        sensor_id = row.get("sensor_id")
+        if sensor_id is None:
+            continue
+        current = latest.get(sensor_id)
+        if current is None or row["time"] > current["time"]:
+            latest[sensor_id] = row
+
+    if not latest:
+        return
+
+    stmt = pg_insert(LatestReading).values([
+        {column: row[column] for column in _LATEST_COLUMNS}
+        for row in latest.values()
+    ])
+    stmt = stmt.on_conflict_do_update(
+        index_elements=[LatestReading.sensor_id],
+        set_={column: getattr(stmt.excluded, column) for column in _LATEST_COLUMNS[1:]},
+        where=stmt.excluded.time >= LatestReading.time
+    )
+    await session.execute(stmt)
+
+
+class SensorIngestBuffer(BaseService):
+    """In-process write-behind queue for sensor readings.
+
+    The CoAP handler validates a reading, enqueues it here and ACKs the
+    request immediately. A background flusher drains the queue into
+    timeseries.sensor_readings with a single multi-row insert whenever the
+    batch reaches INGEST_BUFFER_MAX_ROWS or the oldest queued row is older
+    than INGEST_BUFFER_MAX_AGE_MS. Node last_seen timestamps are folded into
+    the same flush so ingest requests never commit on their own.
+    """
+
+    def __init__(self):
+        super().__init__()
+        self._queue: deque = deque()
+        self._flush_event = asyncio.Event()
+        self._flush_task = None
+        self._running = False
+
+        # Flush triggers
+        self.max_rows = settings.INGEST_BUFFER_MAX_ROWS
+        self.max_age_seconds = settings.INGEST_BUFFER_MAX_AGE_MS / 1000.0
+        self.max_pending = settings.INGEST_BUFFER_MAX_PENDING
+
+        # Backpressure / alerting metrics
+        self.total_rows_enqueued = 0
+        self.total_rows_flushed = 0
+        self.total_rows_dropped = 0
+        self.total_flushes = 0
+        self.failed_flushes = 0
+        self.last_flush_ms = 0.0
+        self.last_flush_rows = 0
+        self.last_flush_at = None
+
+    async def start(self):
+        """Start the background flusher task"""
+        if self._running:
+            return
+        self._running = True
+        self._flush_task = asyncio.create_task(self._flush_loop())
+        logger.info(
+            f"🚀 Sensor ingest buffer started "
+            f"(flush at {self.max_rows} rows / {self.max_age_seconds * 1000:.0f} ms)"
+        )
+
+    async def stop(self):
+        """Stop the flusher, draining everything still queued"""
+        self._running = False
+        self._flush_event.set()
+        if self._flush_task:
+            await self._flush_task
+            self._flush_task = None
+
+        # Drain the whole backlog, not just one batch - _flush_once writes at
+        # most max_rows per call. Failed flushes requeue, so bound the
+        # consecutive failures or a dead database would hang shutdown
+        failures = 0
+        while self._queue and failures < SHUTDOWN_FLUSH_RETRIES:
+            failed_before = self.failed_flushes
+            await self._flush_once()
+            failures = failures + 1 if self.failed_flushes > failed_before else 0
+        if self._queue:
+            logger.error(f"💥 Shutdown drain gave up with {len(self._queue)} readings still queued")
+
+        logger.info("🛑 Sensor ingest buffer stopped")
+
+    def enqueue(self, rows: List[Dict[str, Any]]) -> int:
+        """Enqueue validated reading rows; returns number accepted.
+
+        Under sustained backpressure the oldest queued rows are dropped so
+        the buffer stays bounded - the drop counter is exported for alerting.
+        """
+        enqueue_time = time.monotonic()
+        for row in rows:
+            self._queue.append((enqueue_time, row))
+        self.total_rows_enqueued += len(rows)
+
+        dropped = 0
+        while len(self._queue) > self.max_pending:
+            self._queue.popleft()
+            dropped += 1
+        if dropped:
+            self.total_rows_dropped += dropped
+            logger.error(f"💥 Ingest buffer overflow: dropped {dropped} oldest readings")
+
+        if len(self._queue) >= self.max_rows:
+            self._flush_event.set()
+        return len(rows) - dropped
+
+    @property
+    def queue_depth(self) -> int:
+        return len(self._queue)
+
+    def stats(self) -> Dict[str, Any]:
+        """Queue depth and flush latency for monitoring/alerting"""
+        return {
+            "enabled": settings.INGEST_BUFFER_ENABLED,
+            "queue_depth": self.queue_depth,
+            "max_pending": self.max_pending,
+            "total_rows_enqueued": self.total_rows_enqueued,
+            "total_rows_flushed": self.total_rows_flushed,
+            "total_rows_dropped": self.total_rows_dropped,
+            "total_flushes": self.total_flushes,
+            "failed_flushes": self.failed_flushes,
+            "last_flush_ms": round(self.last_flush_ms, 2),
+            "last_flush_rows": self.last_flush_rows,
+            "last_flush_at": self.last_flush_at,
+        }
+
+    async def health_check(self) -> Dict[str, Any]:
+        health = await super().health_check()
+        health.update(self.stats())
+        if self.queue_depth > self.max_pending * 0.8:
+            health["status"] = "degraded"
+        return health
+
+    async def _flush_loop(self):
+        """Drain the queue on a size-or-age trigger"""
+        while self._running:
+            try:
+                await asyncio.wait_for(self._flush_event.wait(), timeout=self.max_age_seconds)
+            except asyncio.TimeoutError:
+                pass
+            self._flush_event.clear()
+
+            if not self._queue:
+                continue
+
+            # Age trigger: only flush if batch is full or oldest row is due
+            oldest_age = time.monotonic() - self._queue[0][0]
+            if len(self._queue) < self.max_rows and oldest_age < self.max_age_seconds:
+                continue
+
+            await self._flush_once()
+
+    async def _flush_once(self):
+        """Write one batch with a single multi-row insert"""
+        batch = []
+        while self._queue and len(batch) < self.max_rows:
+            batch.append(self._queue.popleft()[1])
+        if not batch:
+            return
+
+        started = time.monotonic()
+        try:
+            async with AsyncSessionLocal() as session:
+                await session.execute(insert(SensorReading), batch)
+
+                # Keep the per-sensor current-state table in the same flush
+                await upsert_latest_readings(session, batch)
+
+                # Fold node last_seen updates into the same transaction
+                last_seen: Dict[str, datetime] = {}
+                for row in batch:
+                    node_id = row["node_id"]
+                    reading_time = row["time"]
+                    if node_id not in last_seen or reading_time > last_seen[node_id]:
+                        last_seen[node_id] = reading_time
+                for node_id, seen_at in last_seen.items():
+                    await session.execute(
+                        update(Node)
+                        .where(Node.node_id == node_id)
+                        .values(last_seen=seen_at)
+                    )
+
+                await session.commit()
+
+            self.last_flush_ms = (time.monotonic() - started) * 1000
+            self.last_flush_rows = len(batch)
+            self.last_flush_at = datetime.utcnow().isoformat() + "Z"
+            self.total_rows_flushed += len(batch)
+            self.total_flushes += 1
+            logger.debug(
+                f"💿 Flushed {len(batch)} readings in {self.last_flush_ms:.1f} ms "
+                f"(queue depth {self.queue_depth})"
+            )
+
+        except Exception as e:
+            self.failed_flushes += 1
+            logger.error(f"💥 Ingest buffer flush failed for {len(batch)} readings: {e}")
+            # Requeue at the front so a transient DB outage does not lose data;
+            # the max_pending bound still applies on the next enqueue.
+            requeue_time = time.monotonic()
+            for row in reversed(batch):
+                self._queue.appendleft((requeue_time, row))
+            await asyncio.sleep(1)
+
+
+# Global ingest buffer instance
+ingest_buffer = SensorIngestBuffer()
@@ -0,0 +1,171 @@
+"""
+Smart Greenhouse IoT System - OTA Rollout Coordinator
+Paces delta firmware downloads across the fleet, per access point
+"""
+
+import logging
+import time
+from datetime import datetime
+from typing import Any, Dict, Optional
+
+logger = logging.getLogger(__name__)
+
+# Concurrent downloads allowed per access point. The firmware image rides
+# the same Wi-Fi the telemetry does, so this is the knob that keeps a
+# rollout from starving ingest on a congested AP
+MAX_DOWNLOADS_PER_AP = 3
+
+# A granted download slot expires if the node never reports back (crashed
+# mid-download, lost power) so stuck nodes cannot wedge their AP's budget
+SLOT_TTL_SECONDS = 900
+
+# What nodes are told to wait before asking again when their AP is busy
+RETRY_AFTER_SECONDS = 60
+
+
+class OTARolloutCoordinator:
+    """Coordinates a firmware rollout across the node fleet.
+
+    An admin registers a release manifest (target version, full image and
+    optionally a compressed binary diff against the previous release).
+    Nodes check in with their current version and access point; the
+    coordinator hands out download slots capped per AP, pointing each node
+    at the delta patch when its installed version matches the diff base
+    and at the full image otherwise. Nodes apply the patch to their
+    inactive partition and report back, freeing the slot.
+
+    State is in-process and per-rollout: a rollout is an operator-driven,
+    hours-long operation, so losing slot state on a backend restart just
+    means the pacing window refills - nodes simply check in again.
+    """
+
+    def __init__(self):
+        self._rollout: Optional[Dict[str, Any]] = None
+        self._leases: Dict[str, Dict[str, Any]] = {}
+
+        self.total_granted = 0
+        self.total_deferred = 0
+        self.total_completed = 0
+        self.total_failed = 0
+        self.total_up_to_date = 0
+
+    @property
+    def active(self) -> bool:
+        return self._rollout is not None
+
+    def start_rollout(self, manifest: Dict[str, Any], started_by: str) -> Dict[str, Any]:
+        """Register a release manifest and open the rollout"""
+        self._rollout = {
+            **manifest,
+            "started_by": started_by,
+            "started_at": datetime.utcnow().isoformat() + "Z",
+        }
+        self._leases.clear()
+        self.total_granted = 0
+        self.total_deferred = 0
+        self.total_completed = 0
+        self.total_failed = 0
+        self.total_up_to_date = 0
+        logger.info(
+            f"🚀 OTA rollout started: version {manifest['version']}"
+            f" (delta from {manifest.get('delta_from') or 'n/a'}) by {started_by}"
+        )
+        return self._rollout
+
+    def cancel_rollout(self) -> None:
+        """Close the rollout; nodes that check in are told nothing is pending"""
+        if self._rollout:
+            logger.info(f"🛑 OTA rollout cancelled: version {self._rollout['version']}")
+        self._rollout = None
+        self._leases.clear()
+
+    def check_in(self, node_id: str, current_version: Optional[str],
+                 access_point: Optional[str]) -> Dict[str, Any]:
+        """Node asks whether (and what) to download right now"""
+        if not self._rollout:
+            return {"update_available": False}
+
+        if current_version == self._rollout["version"]:
+            self.total_up_to_date += 1
+            self._release(node_id)
+            return {"update_available": False}
+
+        self._reap_expired()
+        ap = access_point or "unknown"
+
+        lease = self._leases.get(node_id)
+        if lease is None:
+            ap_active = sum(1 for l in self._leases.values() if l["ap"] == ap)
+            if ap_active >= MAX_DOWNLOADS_PER_AP:
+                self.total_deferred += 1
+                return {
+                    "update_available": True,
+                    "granted": False,
+                    "version": self._rollout["version"],
+                    "retry_after_seconds": RETRY_AFTER_SECONDS,
+                }
+            self._leases[node_id] = {"ap": ap, "granted_at": time.monotonic()}
+            self.total_granted += 1
+            logger.info(f"📦 OTA slot granted to node {node_id} (AP {ap}, {ap_active + 1}/{MAX_DOWNLOADS_PER_AP})")
+
+        # Delta patch only applies cleanly on top of the version it was
+        # diffed against; everyone else gets the full image
+        use_delta = (
+            self._rollout.get("patch_url")
+            and current_version == self._rollout.get("delta_from")
+        )
+        return {
+            "update_available": True,
+            "granted": True,
+            "version": self._rollout["version"],
+            "delta": bool(use_delta),
+            "url": self._rollout["patch_url"] if use_delta else self._rollout["image_url"],
+            "sha256": self._rollout["patch_sha256"] if use_delta else self._rollout["image_sha256"],
+            "size_bytes": self._rollout.get("patch_size_bytes") if use_delta else self._rollout.get("image_size_bytes"),
+        }
+
+    def report_result(self, node_id: str, success: bool, detail: Optional[str] = None) -> None:
+        """Node reports the outcome of its download/apply, freeing its slot"""
+        self._release(node_id)
+        if success:
+            self.total_completed += 1
+            logger.info(f"✅ OTA update completed on node {node_id}")
+        else:
+            self.total_failed += 1
+            logger.warning(f"❌ OTA update failed on node {node_id}: {detail or 'no detail'}")
+
+    def _release(self, node_id: str) -> None:
+        self._leases.pop(node_id, None)
+
+    def _reap_expired(self) -> None:
+        """Free slots whose node never reported back"""
+        cutoff = time.monotonic() - SLOT_TTL_SECONDS
+        expired = [nid for nid, lease in self._leases.items() if lease["granted_at"] < cutoff]
+        for node_id in expired:
+            self._leases.pop(node_id, None)
+            self.total_failed += 1
+            logger.warning(f"⚠️ OTA slot expired for node {node_id} - reclaiming")
+
+    def stats(self) -> Dict[str, Any]:
+        """Rollout progress for monitoring"""
+        self._reap_expired()
+        aps: Dict[str, int] = {}
+        for lease in self._leases.values():
+            aps[lease["ap"]] = aps.get(lease["ap"], 0) + 1
+        return {
+            "active": self.active,
+            "version": self._rollout["version"] if self._rollout else None,
+            "delta_from": self._rollout.get("delta_from") if self._rollout else None,
+            "started_at": self._rollout.get("started_at") if self._rollout else None,
+            "downloads_in_flight": len(self._leases),
+            "downloads_per_ap": aps,
+            "total_granted": self.total_granted,
+            "total_deferred": self.total_deferred,
+            "total_completed": self.total_completed,
+            "total_failed": self.total_failed,
+            "total_up_to_date": self.total_up_to_date,
+        }
+
+
+# Global rollout coordinator instance
+ota_rollout = OTARolloutCoordinator()
@@ -0,0 +1,147 @@
+"""
+Smart Greenhouse IoT System - Live Telemetry Broadcaster
+Fans ingested readings out to dashboard streams, across processes
+"""
+
+import asyncio
+import json
+import logging
+import uuid
+from typing import Any, AsyncGenerator, Dict, Optional, Set
+
+from app.utils.redis_utils import redis_manager
+
+logger = logging.getLogger(__name__)
+
+# Redis channel mirroring every published reading between processes, so
+# dashboards served by the API still stream live data when ingest runs in
+# the separate coap_ingest workers
+RELAY_CHANNEL = "telemetry:readings"
+
+
+class TelemetryBroadcaster:
+    """Fan-out hub between the CoAP ingest path and streaming dashboards.
+
+    Ingest publishes each reading once; every connected dashboard session
+    holds its own bounded queue. A slow consumer drops its own oldest
+    messages instead of applying backpressure to ingest.
+
+    Each publish is also mirrored to a Redis channel and a relay task
+    (started with the first local subscriber) feeds readings published in
+    other processes into the local queues. Envelopes carry an origin tag so
+    a process never re-delivers its own readings. Without Redis the hub
+    degrades to the original in-process-only behavior.
+    """
+
+    SUBSCRIBER_QUEUE_SIZE = 256
+
+    def __init__(self):
+        self._subscribers: Set[asyncio.Queue] = set()
+        self._origin = uuid.uuid4().hex
+        self._relay_task: Optional[asyncio.Task] = None
+        self.total_published = 0
+        self.total_relayed_in = 0
+        self.total_dropped = 0
+
+    @property
+    def subscriber_count(self) -> int:
+        return len(self._subscribers)
+
+    def publish(self, reading: Dict[str, Any]) -> None:
+        """Publish one reading locally and to the relay; never blocks ingest"""
+        self.total_published += 1
+        self._deliver_local(reading)
+
+        if redis_manager.redis:
+            try:
+                loop = asyncio.get_running_loop()
+            except RuntimeError:
+                return
+            envelope = json.dumps({"origin": self._origin, "reading": reading})
+            loop.create_task(self._relay_out(envelope))
+
+    def _deliver_local(self, reading: Dict[str, Any]) -> None:
+        """Push one reading into every local subscriber queue"""
+        if not self._subscribers:
+            return
+        for queue in self._subscribers:
+            try:
+                queue.put_nowait(reading)
+            except asyncio.QueueFull:
+                # Drop this subscriber's oldest message to make room
+                try:
+                    queue.get_nowait()
+                    queue.put_nowait(reading)
+                except (asyncio.QueueEmpty, asyncio.QueueFull):
+                    pass
+                self.total_dropped += 1
+
+    async def _relay_out(self, envelope: str) -> None:
+        try:
+            await redis_manager.redis.publish(RELAY_CHANNEL, envelope)
+        except Exception as e:
+            logger.debug(f"Telemetry relay publish failed: {e}")
+
+    def _ensure_relay(self) -> None:
+        """Start the inbound relay once there is someone to deliver to"""
+        if self._relay_task or not redis_manager.redis:
+            return
+        self._relay_task = asyncio.create_task(self._relay_loop())
+        logger.info(f"📡 Telemetry relay subscribed to Redis channel {RELAY_CHANNEL}")
+
+    async def _relay_loop(self) -> None:
+        """Deliver readings published in other processes to local queues"""
+        pubsub = redis_manager.redis.pubsub()
+        try:
+            await pubsub.subscribe(RELAY_CHANNEL)
+            async for message in pubsub.listen():
+                if message.get("type") != "message":
+                    continue
+                try:
+                    envelope = json.loads(message["data"])
+                except (TypeError, ValueError):
+                    continue
+                if envelope.get("origin") == self._origin:
+                    continue  # already delivered locally at publish time
+                reading = envelope.get("reading")
+                if reading:
+                    self.total_relayed_in += 1
+                    self._deliver_local(reading)
+        except asyncio.CancelledError:
+            raise
+        except Exception as e:
+            logger.error(f"💥 Telemetry relay failed: {e}")
+        finally:
+            # Allow the next subscriber to restart the relay after a failure
+            self._relay_task = None
+            try:
+                await pubsub.close()
+            except Exception:
+                pass
+
+    async def subscribe(self) -> AsyncGenerator[Dict[str, Any], None]:
+        """Yield readings as they arrive until the consumer disconnects"""
+        self._ensure_relay()
+        queue: asyncio.Queue = asyncio.Queue(maxsize=self.SUBSCRIBER_QUEUE_SIZE)
+        self._subscribers.add(queue)
+        logger.info(f"📡 Telemetry subscriber connected ({self.subscriber_count} active)")
+        try:
+            while True:
+                yield await queue.get()
+        finally:
+            self._subscribers.discard(queue)
+            logger.info(f"📡 Telemetry subscriber disconnected ({self.subscriber_count} active)")
+
+    def stats(self) -> Dict[str, Any]:
+        """Fan-out metrics for monitoring"""
+        return {
+            "subscribers": self.subscriber_count,
+            "total_published": self.total_published,
+            "total_relayed_in": self.total_relayed_in,
+            "total_dropped": self.total_dropped,
+            "relay_running": self._relay_task is not None,
+        }
+
+
+# Global telemetry broadcaster instance
+telemetry_stream = TelemetryBroadcaster()
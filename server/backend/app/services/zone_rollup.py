@@ -0,0 +1,240 @@
+"""
+Smart Greenhouse IoT System - Incremental Zone Rollup
+Folds new sensor readings into the timeseries.zone_aggregates hypertable
+"""
+
+import asyncio
+import logging
+from datetime import datetime, timedelta
+from typing import Any, Dict, Optional
+
+from sqlalchemy import select, text
+
+from app.core.config import get_settings
+from app.db.database import AsyncSessionLocal
+from app.models.models import SystemConfig
+from app.services.base_service import BaseService
+
+logger = logging.getLogger(__name__)
+settings = get_settings()
+
+HIGH_WATER_MARK_KEY = "zone_rollup_high_water_mark"
+
+# Pivoted incremental rollup: one pass over the new readings produces one
+# row per (bucket, zone). Per-metric reading counts go into the metadata
+# JSON so the zone-statistics endpoint can report exact counts without a
+# schema change.
+ROLLUP_SQL = text("""
+    INSERT INTO timeseries.zone_aggregates (
+        time, zone_id, time_bucket_minutes,
+        avg_temperature, min_temperature, max_temperature,
+        avg_humidity, min_humidity, max_humidity,
+        avg_soil_moisture, min_soil_moisture, max_soil_moisture,
+        avg_light, data_points_count, metadata
+    )
+    SELECT
+        time_bucket(:bucket_interval ::interval, time) AS bucket,
+        zone_id,
+        :bucket_minutes,
+        AVG(value) FILTER (WHERE sensor_type = 'temperature'),
+        MIN(value) FILTER (WHERE sensor_type = 'temperature'),
+        MAX(value) FILTER (WHERE sensor_type = 'temperature'),
+        AVG(value) FILTER (WHERE sensor_type = 'humidity'),
+        MIN(value) FILTER (WHERE sensor_type = 'humidity'),
+        MAX(value) FILTER (WHERE sensor_type = 'humidity'),
+        AVG(value) FILTER (WHERE sensor_type = 'soil_moisture'),
+        MIN(value) FILTER (WHERE sensor_type = 'soil_moisture'),
+        MAX(value) FILTER (WHERE sensor_type = 'soil_moisture'),
+        ROUND(AVG(value) FILTER (WHERE sensor_type = 'light'))::INTEGER,
+        COUNT(*),
+        jsonb_build_object(
+            'temperature_count', COUNT(*) FILTER (WHERE sensor_type = 'temperature'),
+            'humidity_count', COUNT(*) FILTER (WHERE sensor_type = 'humidity'),
+            'soil_moisture_count', COUNT(*) FILTER (WHERE sensor_type = 'soil_moisture'),
+            'light_count', COUNT(*) FILTER (WHERE sensor_type = 'light')
+        )
+    FROM timeseries.sensor_readings
+    WHERE zone_id IS NOT NULL
+      AND time >= :from_time
+      AND time < :until_time
+    GROUP BY bucket, zone_id
+""")
+
+# zone_aggregates has no unique key (it is a hypertable), so re-folding a
+# window means clearing its rows first and re-inserting in the same
+# transaction
+CLEAR_WINDOW_SQL = text("""
+    DELETE FROM timeseries.zone_aggregates
+    WHERE time >= :from_time
+      AND time < :until_time
+      AND time_bucket_minutes = :bucket_minutes
+""")
+
+
+class ZoneRollupService(BaseService):
+    """Scheduled incremental rollup into timeseries.zone_aggregates.
+
+    Tracks a high-water mark in greenhouse.system_config so each cycle
+    only touches readings that arrived since the previous run. Buckets
+    are only rolled up once they are closed, so late rows flushed by the
+    write-behind ingest buffer are still counted.
+
+    Readings can also arrive with timestamps that are already behind the
+    mark (batch backfills, firmware replaying data buffered offline), so
+    each cycle additionally re-folds the trailing
+    ZONE_ROLLUP_LOOKBACK_MINUTES window by deleting and recomputing those
+    buckets. Rows arriving with timestamps older than the lookback are
+    never folded - zone_aggregates undercounts them relative to the raw
+    readings until the lookback is widened and the window replayed.
+    """
+
+    def __init__(self):
+        super().__init__()
+        self._rollup_task = None
+        self._running = False
+
+        self.total_cycles = 0
+        self.failed_cycles = 0
+        self.last_rollup_until: Optional[str] = None
+        self.last_cycle_ms = 0.0
+
+    @property
+    def bucket_minutes(self) -> int:
+        return settings.ZONE_ROLLUP_BUCKET_MINUTES
+
+    async def start(self):
+        """Start the periodic rollup task"""
+        if self._running:
+            return
+        self._running = True
+        self._rollup_task = asyncio.create_task(self._rollup_loop())
+        logger.info(
+            f"🚀 Zone rollup started (every {settings.ZONE_ROLLUP_INTERVAL_SECONDS}s, "
+            f"{self.bucket_minutes}-minute buckets)"
+        )
+
+    async def stop(self):
+        """Stop the periodic rollup task"""
+        self._running = False
+        if self._rollup_task:
+            self._rollup_task.cancel()
+            try:
+                await self._rollup_task
+            except asyncio.CancelledError:
+                pass
+            self._rollup_task = None
+        logger.info("🛑 Zone rollup stopped")
+
+    def stats(self) -> Dict[str, Any]:
+        """Rollup progress counters for monitoring"""
+        return {
+            "enabled": settings.ZONE_ROLLUP_ENABLED,
+            "interval_seconds": settings.ZONE_ROLLUP_INTERVAL_SECONDS,
+            "bucket_minutes": self.bucket_minutes,
+            "lookback_minutes": settings.ZONE_ROLLUP_LOOKBACK_MINUTES,
+            "total_cycles": self.total_cycles,
+            "failed_cycles": self.failed_cycles,
+            "last_rollup_until": self.last_rollup_until,
+            "last_cycle_ms": round(self.last_cycle_ms, 2),
+        }
+
+    async def health_check(self) -> Dict[str, Any]:
+        health = await super().health_check()
+        health.update(self.stats())
+        return health
+
+    async def _rollup_loop(self):
+        while self._running:
+            try:
+                await asyncio.sleep(settings.ZONE_ROLLUP_INTERVAL_SECONDS)
+                await self.run_once()
+            except asyncio.CancelledError:
+                raise
+            except Exception as e:
+                self.failed_cycles += 1
+                logger.error(f"💥 Zone rollup cycle failed: {str(e)}")
+
+    async def run_once(self) -> int:
+        """Roll up all closed buckets since the high-water mark.
+
+        Also re-folds the lookback window behind the mark so late-arriving
+        rows with old timestamps are picked up. Returns the number of
+        bucket-minutes processed (0 when already caught up).
+        """
+        cycle_started = datetime.utcnow()
+        bucket = timedelta(minutes=self.bucket_minutes)
+
+        async with AsyncSessionLocal() as session:
+            high_water_mark = await self._get_high_water_mark(session)
+
+            # Only fold buckets that have fully closed; the open bucket is
+            # picked up on a later cycle once it can no longer change
+            now = datetime.utcnow()
+            until_time = now - (now - datetime.min) % bucket
+
+            if until_time <= high_water_mark:
+                return 0
+
+            # Reach back past the mark to catch rows that arrived with old
+            # timestamps, aligned down so only whole buckets are recomputed
+            from_time = high_water_mark - timedelta(
+                minutes=settings.ZONE_ROLLUP_LOOKBACK_MINUTES
+            )
+            from_time = from_time - (from_time - datetime.min) % bucket
+
+            params = {
+                "bucket_minutes": self.bucket_minutes,
+                "from_time": from_time,
+                "until_time": until_time,
+            }
+            await session.execute(CLEAR_WINDOW_SQL, params)
+            await session.execute(ROLLUP_SQL, {
+                "bucket_interval": f"{self.bucket_minutes} minutes",
+                **params,
+            })
+            await self._set_high_water_mark(session, until_time)
+            await session.commit()
+
+        self.total_cycles += 1
+        self.last_rollup_until = until_time.isoformat() + "Z"
+        self.last_cycle_ms = (datetime.utcnow() - cycle_started).total_seconds() * 1000
+        processed_minutes = int((until_time - from_time).total_seconds() / 60)
+        logger.info(
+            f"📊 Zone rollup advanced to {self.last_rollup_until} "
+            f"({processed_minutes} minutes folded in {self.last_cycle_ms:.0f}ms)"
+        )
+        return processed_minutes
+
+    async def _get_high_water_mark(self, session) -> datetime:
+        """Read the rollup high-water mark, seeding it on first run"""
+        result = await session.execute(
+            select(SystemConfig).where(SystemConfig.config_key == HIGH_WATER_MARK_KEY)
+        )
+        config = result.scalar_one_or_none()
+        if config and isinstance(config.config_value, dict) and config.config_value.get("until"):
+            return datetime.fromisoformat(config.config_value["until"])
+
+        # First run: start one hour back rather than replaying all history
+        seeded = datetime.utcnow() - timedelta(hours=1)
+        logger.info(f"📋 Zone rollup high-water mark seeded at {seeded.isoformat()}Z")
+        return seeded
+
+    async def _set_high_water_mark(self, session, until_time: datetime) -> None:
+        """Persist the high-water mark in the same transaction as the rollup"""
+        result = await session.execute(
+            select(SystemConfig).where(SystemConfig.config_key == HIGH_WATER_MARK_KEY)
+        )
+        config = result.scalar_one_or_none()
+        value = {"until": until_time.isoformat()}
+        if config:
+            config.config_value = value
+        else:
+            session.add(SystemConfig(
+                config_key=HIGH_WATER_MARK_KEY,
+                config_value=value,
+                description="Zone rollup progress - readings before this time are folded into zone_aggregates"
+            ))
+
+
+# Global zone rollup instance
+zone_rollup = ZoneRollupService()
@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+"""
+Fleet-Scale Ingest Benchmark for Smart Greenhouse IoT System
+Simulates N virtual nodes posting sensor data over CoAP and/or HTTP with
+realistic duty cycles and reports p50/p95/p99 ingest latency, sustained
+rows/sec and error rates. Results can be saved as a baseline JSON and
+later runs diffed against it (non-zero exit on regression) so CI can
+catch throughput regressions in coap_server.py / sensors_router.py
+before they hit production.
+
+Usage examples:
+    python benchmark_ingest.py --nodes 100 --duration 30 --protocol coap
+    python benchmark_ingest.py --nodes 1000 --duration 60 --protocol both \
+        --save-baseline
+    python benchmark_ingest.py --nodes 1000 --duration 60 \
+        --baseline-file ingest_baseline.json --max-regression 20
+"""
+
+import argparse
+import asyncio
+import json
+import random
+import statistics
+import sys
+import time
+from datetime import datetime
+
+try:
+    import aiocoap
+    from aiocoap import Message, Code
+    COAP_AVAILABLE = True
+except ImportError:
+    COAP_AVAILABLE = False
+
+try:
+    import httpx
+    HTTPX_AVAILABLE = True
+except ImportError:
+    HTTPX_AVAILABLE = False
+
+# Matches NODE_API_KEYS in app/core/config.py; virtual nodes cycle through
+# these so auth succeeds against a default deployment
+KNOWN_NODES = [
+    ("greenhouse_001", "gh001_api_key_abc123"),
+    ("greenhouse_002", "gh002_api_key_def456"),
+    ("greenhouse_003", "gh003_api_key_ghi789"),
+]
+
+ZONES = ["A1", "A2", "A3", "B1", "B2", "B3", "C1", "C2", "C3"]
+
+
+def make_payload(node_id: str, api_key: str) -> dict:
+    """One realistic sensor submission (9 readings per post)"""
+    return {
+        "node_id": node_id,
+        "api_key": api_key,
+        "zone_id": random.choice(ZONES),
+        "timestamp": datetime.utcnow().isoformat(),
+        "temperature": round(random.uniform(15.0, 35.0), 2),
+        "humidity": round(random.uniform(30.0, 90.0), 2),
+        "soil_moisture": round(random.uniform(20.0, 80.0), 2),
+        "light": random.randint(0, 60000),
+        "ph": round(random.uniform(5.5, 7.5), 2),
+        "ec": round(random.uniform(0.5, 2.5), 2),
+        "battery_percentage": round(random.uniform(20.0, 100.0), 1),
+        "signal_strength": random.randint(-90, -30),
+        "voltage": round(random.uniform(3.0, 4.2), 2),
+    }
+
+
+class BenchmarkStats:
+    """Latency/throughput accumulator for one protocol"""
+
+    def __init__(self, name: str):
+        self.name = name
+        self.latencies_ms = []
+        self.successes = 0
+        self.errors = 0
+        self.readings_acked = 0
+
+    def record(self, latency_ms: float, ok: bool, readings: int = 0):
+        self.latencies_ms.append(latency_ms)
+        if ok:
+            self.successes += 1
+            self.readings_acked += readings
+        else:
+            self.errors += 1
+
+    def summary(self, duration_s: float) -> dict:
+        total = self.successes + self.errors
+        lat = sorted(self.latencies_ms)
+
+        def pct(p):
+            if not lat:
+                return None
+            return round(lat[min(len(lat) - 1, int(len(lat) * p / 100))], 2)
+
+        return {
+            "protocol": self.name,
+            "requests": total,
+            "successes": self.successes,
+            "errors": self.errors,
+            "error_rate_pct": round(100.0 * self.errors / total, 2) if total else 0.0,
+            "requests_per_sec": round(total / duration_s, 1) if duration_s else 0.0,
+            "rows_per_sec": round(self.readings_acked / duration_s, 1) if duration_s else 0.0,
+            "latency_ms": {
+                "p50": pct(50),
+                "p95": pct(95),
+                "p99": pct(99),
+                "mean": round(statistics.fmean(lat), 2) if lat else None,
+                "max": round(lat[-1], 2) if lat else None,
+            },
+        }
+
+
+async def coap_node(index: int, args, stats: BenchmarkStats, deadline: float):
+    """One virtual node posting over CoAP until the deadline"""
+    node_id, api_key = KNOWN_NODES[index % len(KNOWN_NODES)]
+    context = await aiocoap.Context.create_client_context()
+    uri = f"coap://{args.host}:{args.coap_port}/sensor/send-data"
+    try:
+        # Stagger start so the fleet doesn't post in lockstep
+        await asyncio.sleep(random.uniform(0, args.interval))
+        while time.monotonic() < deadline:
+            payload = json.dumps(make_payload(node_id, api_key)).encode("utf-8")
+            started = time.monotonic()
+            try:
+                message = Message(code=Code.POST, uri=uri, payload=payload)
+                response = await asyncio.wait_for(
+                    context.request(message).response, timeout=args.timeout
+                )
+                latency = (time.monotonic() - started) * 1000
+                ok = response.code.is_successful()
+                readings = 0
+                if ok:
+                    try:
+                        readings = json.loads(response.payload.decode("utf-8")).get("readings_count", 9)
+                    except (ValueError, KeyError):
+                        readings = 9
+                stats.record(latency, ok, readings)
+            except Exception:
+                stats.record((time.monotonic() - started) * 1000, False)
+            # Duty cycle with +-30% jitter
+            await asyncio.sleep(args.interval * random.uniform(0.7, 1.3))
+    finally:
+        await context.shutdown()
+
+
+async def http_node(index: int, args, stats: BenchmarkStats, deadline: float, client):
+    """One virtual node posting over HTTP until the deadline"""
+    node_id, api_key = KNOWN_NODES[index % len(KNOWN_NODES)]
+    url = f"http://{args.host}:{args.http_port}/api/sensor-data"
+    await asyncio.sleep(random.uniform(0, args.interval))
+    while time.monotonic() < deadline:
+        payload = make_payload(node_id, api_key)
+        payload.pop("api_key")
+        started = time.monotonic()
+        try:
+            response = await client.post(
+                url,
+                json=payload,
+                headers={"X-API-Key": api_key},
+                timeout=args.timeout,
+            )
+            latency = (time.monotonic() - started) * 1000
+            ok = response.status_code < 400
+            readings = 0
+            if ok:
+                try:
+                    readings = response.json().get("data_points", 9)
+                except ValueError:
+                    readings = 9
+            stats.record(latency, ok, readings)
+        except Exception:
+            stats.record((time.monotonic() - started) * 1000, False)
+        await asyncio.sleep(args.interval * random.uniform(0.7, 1.3))
+
+
+async def run_benchmark(args) -> dict:
+    deadline = time.monotonic() + args.duration
+    started = time.monotonic()
+    tasks = []
+    all_stats = []
+
+    http_client = None
+    if args.protocol in ("http", "both"):
+        if not HTTPX_AVAILABLE:
+            print("❌ httpx not installed - cannot benchmark HTTP")
+            sys.exit(2)
+        http_stats = BenchmarkStats("http")
+        all_stats.append(http_stats)
+        http_client = httpx.AsyncClient()
+
+    if args.protocol in ("coap", "both"):
+        if not COAP_AVAILABLE:
+            print("❌ aiocoap not installed - cannot benchmark CoAP")
+            sys.exit(2)
+        coap_stats = BenchmarkStats("coap")
+        all_stats.append(coap_stats)
+
+    node_count = args.nodes
+    split = node_count // 2 if args.protocol == "both" else node_count
+
+    if args.protocol in ("coap", "both"):
+        coap_count = split if args.protocol == "both" else node_count
+        for i in range(coap_count):
+            tasks.append(coap_node(i, args, coap_stats, deadline))
+    if args.protocol in ("http", "both"):
+        http_count = node_count - split if args.protocol == "both" else node_count
+        for i in range(http_count):
+            tasks.append(http_node(i, args, http_stats, deadline, http_client))
+
+    print(f"🚀 Starting {node_count} virtual nodes for {args.duration}s "
+          f"(protocol={args.protocol}, interval={args.interval}s)")
+    await asyncio.gather(*tasks)
+    if http_client:
+        await http_client.aclose()
+
+    duration = time.monotonic() - started
+    return {
+        "timestamp": datetime.utcnow().isoformat() + "Z",
+        "config": {
+            "nodes": args.nodes,
+            "duration_s": args.duration,
+            "protocol": args.protocol,
+            "interval_s": args.interval,
+        },
+        "results": [s.summary(duration) for s in all_stats],
+    }
+
+
+def compare_to_baseline(report: dict, baseline: dict, max_regression_pct: float) -> bool:
+    """Print the diff against the baseline; returns True when acceptable"""
+    ok = True
+    baseline_by_proto = {r["protocol"]: r for r in baseline.get("results", [])}
+    for result in report["results"]:
+        base = baseline_by_proto.get(result["protocol"])
+        if not base:
+            continue
+        print(f"\n📊 {result['protocol']} vs baseline ({baseline.get('timestamp', '?')}):")
+        for metric, current, previous in [
+            ("rows_per_sec", result["rows_per_sec"], base["rows_per_sec"]),
+            ("p95_latency_ms", result["latency_ms"]["p95"], base["latency_ms"]["p95"]),
+            ("p99_latency_ms", result["latency_ms"]["p99"], base["latency_ms"]["p99"]),
+            ("error_rate_pct", result["error_rate_pct"], base["error_rate_pct"]),
+        ]:
+            if current is None or previous is None:
+                continue
+            delta = current - previous
+            print(f"  {metric}: {previous} → {current} ({delta:+.2f})")
+            # Throughput down or latency/errors up beyond threshold = regression
+            if metric == "rows_per_sec" and previous > 0:
+                if (previous - current) / previous * 100 > max_regression_pct:
+                    print(f"  ❌ {metric} regressed more than {max_regression_pct}%")
+                    ok = False
+            elif previous > 0 and (current - previous) / previous * 100 > max_regression_pct:
+                print(f"  ❌ {metric} regressed more than {max_regression_pct}%")
+                ok = False
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fleet-scale ingest benchmark")
+    parser.add_argument("--nodes", type=int, default=100,
+                        help="Number of virtual nodes (up to 10000)")
+    parser.add_argument("--duration", type=int, default=30,
+                        help="Benchmark duration in seconds")
+    parser.add_argument("--protocol", choices=["coap", "http", "both"], default="coap")
+    parser.add_argument("--interval", type=float, default=5.0,
+                        help="Mean seconds between posts per node (duty cycle)")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--coap-port", type=int, default=5683)
+    parser.add_argument("--http-port", type=int, default=8000)
+    parser.add_argument("--timeout", type=float, default=10.0,
+                        help="Per-request timeout in seconds")
+    parser.add_argument("--baseline-file", default="ingest_baseline.json")
+    parser.add_argument("--save-baseline", action="store_true",
+                        help="Write this run as the new baseline")
+    parser.add_argument("--max-regression", type=float, default=20.0,
+                        help="Allowed regression vs baseline in percent")
+    args = parser.parse_args()
+
+    if args.nodes < 1 or args.nodes > 10000:
+        parser.error("--nodes must be between 1 and 10000")
+
+    report = asyncio.run(run_benchmark(args))
+
+    print("\n" + "=" * 60)
+    print(json.dumps(report, indent=2))
+
+    if args.save_baseline:
+        with open(args.baseline_file, "w") as f:
+            json.dump(report, f, indent=2)
+        print(f"\n💾 Baseline saved to {args.baseline_file}")
+        return
+
+    try:
+        with open(args.baseline_file) as f:
+            baseline = json.load(f)
+    except FileNotFoundError:
+        print(f"\n⚠️ No baseline file at {args.baseline_file} - run with --save-baseline first")
+        return
+
+    if not compare_to_baseline(report, baseline, args.max_regression):
+        print("\n❌ Benchmark regressed beyond threshold")
+        sys.exit(1)
+    print("\n✅ Within regression threshold")
+
+
+if __name__ == "__main__":
+    main()
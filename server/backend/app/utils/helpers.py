@@ -2,6 +2,7 @@
 Common utility functions
 """
 
+import base64
 import hashlib
 import secrets
 import string
@@ -47,6 +48,25 @@ def parse_datetime(dt_str: str) -> datetime:
         return datetime.strptime(dt_str, "%Y-%m-%dT%H:%M:%S")
 
 
+def encode_cursor(created_at: datetime, item_id: Any) -> str:
+    """Encode a keyset pagination cursor as an opaque base64 token"""
+    payload = json.dumps({"c": created_at.isoformat(), "i": str(item_id)})
+    return base64.urlsafe_b64encode(payload.encode()).decode().rstrip("=")
+
+
+def decode_cursor(token: str) -> Optional[Dict[str, Any]]:
+    """Decode a keyset pagination cursor; returns None if malformed"""
+    try:
+        padded = token + "=" * (-len(token) % 4)
+        payload = json.loads(base64.urlsafe_b64decode(padded.encode()))
+        return {
+            "created_at": parse_datetime(payload["c"]),
+            "id": payload["i"]
+        }
+    except Exception:
+        return None
+
+
 def sanitize_filename(filename: str) -> str:
     """Sanitize filename for safe file operations"""
     invalid_chars = '<>:"/\\|?*'
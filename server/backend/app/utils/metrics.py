@@ -0,0 +1,126 @@
+"""
+Smart Greenhouse IoT System - Prometheus Metrics
+Counters, histograms and gauges for the ingest and query hot paths.
+
+This module must stay import-light (no app.* imports) so the CoAP server,
+database layer and Redis manager can all pull metrics in without creating
+import cycles. When prometheus-client is not installed every metric is a
+no-op, so instrumented code never has to check availability itself.
+"""
+
+import logging
+
+logger = logging.getLogger(__name__)
+
+try:
+    from prometheus_client import (
+        Counter,
+        Gauge,
+        Histogram,
+        generate_latest,
+        CONTENT_TYPE_LATEST,
+    )
+    PROMETHEUS_AVAILABLE = True
+except ImportError:
+    PROMETHEUS_AVAILABLE = False
+    CONTENT_TYPE_LATEST = "text/plain"
+    logger.warning("prometheus-client not available - metrics will be no-ops")
+
+
+class _NoopMetric:
+    """Stand-in when prometheus-client is missing; swallows every call"""
+
+    def labels(self, *args, **kwargs):
+        return self
+
+    def inc(self, amount: float = 1):
+        pass
+
+    def observe(self, value: float):
+        pass
+
+    def set(self, value: float):
+        pass
+
+
+if PROMETHEUS_AVAILABLE:
+    # CoAP ingest path
+    COAP_REQUESTS_TOTAL = Counter(
+        "greenhouse_coap_requests_total",
+        "CoAP sensor submissions by outcome",
+        ["outcome"]
+    )
+    COAP_PAYLOAD_PARSE_SECONDS = Histogram(
+        "greenhouse_coap_payload_parse_seconds",
+        "Time spent decoding CoAP sensor payloads",
+        ["format"],
+        buckets=(0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1)
+    )
+
+    # Database layer
+    DB_SESSION_WAIT_SECONDS = Histogram(
+        "greenhouse_db_session_wait_seconds",
+        "Wait to acquire an async database session from the pool",
+        buckets=(0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0)
+    )
+
+    # HTTP API
+    HTTP_REQUEST_DURATION_SECONDS = Histogram(
+        "greenhouse_http_request_duration_seconds",
+        "HTTP request latency by method, path and status",
+        ["method", "path", "status"],
+        buckets=(0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0)
+    )
+
+    # Redis caches
+    REDIS_CACHE_OPS_TOTAL = Counter(
+        "greenhouse_redis_cache_ops_total",
+        "Redis cache lookups by cache name and result (hit/miss/error)",
+        ["cache", "result"]
+    )
+
+    # Actuator command dispatch (publish to drain, per priority class)
+    COMMAND_DISPATCH_LATENCY_SECONDS = Histogram(
+        "greenhouse_command_dispatch_latency_seconds",
+        "Actuator command queue latency from publish to drain by priority class",
+        ["priority"],
+        buckets=(0.01, 0.05, 0.1, 0.25, 0.5, 1.0, 5.0, 30.0, 120.0)
+    )
+
+    # Write-behind ingest buffer (gauges refreshed by the /metrics endpoint)
+    INGEST_BUFFER_PENDING = Gauge(
+        "greenhouse_ingest_buffer_pending_rows",
+        "Sensor readings waiting in the write-behind buffer"
+    )
+    INGEST_BUFFER_FLUSHED_TOTAL = Gauge(
+        "greenhouse_ingest_buffer_flushed_rows_total",
+        "Sensor readings flushed to the database since startup"
+    )
+    INGEST_BUFFER_DROPPED_TOTAL = Gauge(
+        "greenhouse_ingest_buffer_dropped_rows_total",
+        "Sensor readings dropped under backpressure since startup"
+    )
+else:
+    COAP_REQUESTS_TOTAL = _NoopMetric()
+    COAP_PAYLOAD_PARSE_SECONDS = _NoopMetric()
+    DB_SESSION_WAIT_SECONDS = _NoopMetric()
+    HTTP_REQUEST_DURATION_SECONDS = _NoopMetric()
+    REDIS_CACHE_OPS_TOTAL = _NoopMetric()
+    COMMAND_DISPATCH_LATENCY_SECONDS = _NoopMetric()
+    INGEST_BUFFER_PENDING = _NoopMetric()
+    INGEST_BUFFER_FLUSHED_TOTAL = _NoopMetric()
+    INGEST_BUFFER_DROPPED_TOTAL = _NoopMetric()
+
+
+def update_ingest_buffer_gauges(stats: dict) -> None:
+    """Refresh buffer gauges from SensorIngestBuffer.stats() output"""
+    INGEST_BUFFER_PENDING.set(stats.get("queue_depth", 0))
+    INGEST_BUFFER_FLUSHED_TOTAL.set(stats.get("total_rows_flushed", 0))
+    INGEST_BUFFER_DROPPED_TOTAL.set(stats.get("total_rows_dropped", 0))
+
+
+def render_metrics() -> bytes:
+    """Serialize the default registry in Prometheus exposition format"""
+    if not PROMETHEUS_AVAILABLE:
+        return b"# prometheus-client not installed\n"
+    return generate_latest()
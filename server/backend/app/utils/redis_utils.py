@@ -6,21 +6,51 @@ High-performance caching and session management
 import redis.asyncio as redis
 import json
 import logging
+import time
 from typing import Optional, Dict, Any, List
 from datetime import datetime, timedelta
 import hashlib
 
 from app.core.config import get_settings
+from app.utils.metrics import REDIS_CACHE_OPS_TOTAL
 
 logger = logging.getLogger(__name__)
 settings = get_settings()
 
+# Atomic sliding-window rate limit: prune, add, count, expire and fetch the
+# oldest entry in one server-side round trip. ARGV[5..] carries timestamps
+# of hits absorbed by the local micro-cache since the last call, so they
+# land in the window in the same round trip they amortized.
+RATE_LIMIT_LUA = """
+for i = 5, #ARGV do
+    redis.call('ZADD', KEYS[1], ARGV[i], ARGV[i] .. ':local:' .. i)
+end
+redis.call('ZREMRANGEBYSCORE', KEYS[1], 0, ARGV[2])
+redis.call('ZADD', KEYS[1], ARGV[1], ARGV[3])
+local count = redis.call('ZCARD', KEYS[1])
+redis.call('EXPIRE', KEYS[1], ARGV[4])
+local oldest = redis.call('ZRANGE', KEYS[1], 0, 0, 'WITHSCORES')
+local oldest_score = '-1'
+if oldest[2] then oldest_score = oldest[2] end
+return {count, oldest_score}
+"""
+
 class RedisManager:
     """Redis connection and operations manager"""
-    
+
+    # How long an identifier far under its limit may skip Redis entirely
+    RATE_LIMIT_LOCAL_TTL = 1.0
+    # Most hits one micro-cache entry may absorb before falling through to
+    # Redis. Keeps the unrecorded allowance a small constant rather than a
+    # fraction of the limit, so the fast path cannot compound per second
+    RATE_LIMIT_LOCAL_BURST = 10
+
     def __init__(self):
         self.redis: Optional[redis.Redis] = None
         self._connection_pool = None
+        self._rate_limit_script = None
+        # Per-process micro-cache: identifier -> short-lived local estimate
+        self._rate_limit_local: Dict[str, Dict[str, Any]] = {}
     
     async def connect(self):
         """Initialize Redis connection"""
@@ -74,9 +104,11 @@ class RedisManager:
         try:
             key = f"api_key:{api_key}"
             node_id = await self.redis.get(key)
+            REDIS_CACHE_OPS_TOTAL.labels(cache="api_key", result="hit" if node_id else "miss").inc()
             return node_id
         except Exception as e:
             logger.error(f"Failed to get node by API key: {str(e)}")
+            REDIS_CACHE_OPS_TOTAL.labels(cache="api_key", result="error").inc()
             return None
     
     async def invalidate_api_key(self, api_key: str) -> bool:
@@ -107,11 +139,13 @@ class RedisManager:
         try:
             key = f"session:{session_token}"
             data = await self.redis.get(key)
+            REDIS_CACHE_OPS_TOTAL.labels(cache="session", result="hit" if data else "miss").inc()
             if data:
                 return json.loads(data)
             return None
         except Exception as e:
             logger.error(f"Failed to get session: {str(e)}")
+            REDIS_CACHE_OPS_TOTAL.labels(cache="session", result="error").inc()
             return None
     
     async def update_session(self, session_token: str, user_data: Dict[str, Any], extend_ttl: bool = True) -> bool:
@@ -139,50 +173,180 @@ class RedisManager:
             logger.error(f"Failed to delete session: {str(e)}")
             return False
     
+    # Batch Ingest Jobs
+    async def set_batch_job_status(self, job_id: str, status_data: Dict[str, Any], ttl: int = 3600) -> bool:
+        """Store async batch ingest job status for polling"""
+        try:
+            key = f"batch_job:{job_id}"
+            data = json.dumps(status_data, default=str)
+            await self.redis.setex(key, ttl, data)
+            return True
+        except Exception as e:
+            logger.error(f"Failed to set batch job status: {str(e)}")
+            return False
+
+    async def get_batch_job_status(self, job_id: str) -> Optional[Dict[str, Any]]:
+        """Get async batch ingest job status"""
+        try:
+            key = f"batch_job:{job_id}"
+            data = await self.redis.get(key)
+            if data:
+                return json.loads(data)
+            return None
+        except Exception as e:
+            logger.error(f"Failed to get batch job status: {str(e)}")
+            return None
+
+    # User Claims Cache (resolved identity per token, no DB round trip)
+    USER_CLAIMS_TTL = 300
+
+    @staticmethod
+    def _token_hash(token: str) -> str:
+        """Key claims on the token digest so raw JWTs never become keys"""
+        return hashlib.sha256(token.encode('utf-8')).hexdigest()
+
+    async def cache_user_claims(self, token: str, claims: Dict[str, Any], ttl: int = None) -> bool:
+        """Cache resolved user claims for a token and index it per user"""
+        try:
+            ttl = ttl or self.USER_CLAIMS_TTL
+            user_id = str(claims.get("user_id"))
+            pipe = self.redis.pipeline()
+            pipe.setex(f"user_claims:{self._token_hash(token)}", ttl, json.dumps(claims, default=str))
+            # Track the user's live tokens so role changes and logout can
+            # revoke every cached identity at once
+            pipe.sadd(f"user_tokens:{user_id}", token)
+            pipe.expire(f"user_tokens:{user_id}", settings.SESSION_TTL)
+            await pipe.execute()
+            return True
+        except Exception as e:
+            logger.error(f"Failed to cache user claims: {str(e)}")
+            return False
+
+    async def get_user_claims(self, token: str) -> Optional[Dict[str, Any]]:
+        """Get cached user claims for a token"""
+        try:
+            data = await self.redis.get(f"user_claims:{self._token_hash(token)}")
+            REDIS_CACHE_OPS_TOTAL.labels(cache="user_claims", result="hit" if data else "miss").inc()
+            if data:
+                return json.loads(data)
+            return None
+        except Exception as e:
+            logger.error(f"Failed to get user claims: {str(e)}")
+            REDIS_CACHE_OPS_TOTAL.labels(cache="user_claims", result="error").inc()
+            return None
+
+    async def invalidate_user_claims(self, token: str) -> bool:
+        """Drop the cached claims for one token"""
+        try:
+            await self.redis.delete(f"user_claims:{self._token_hash(token)}")
+            return True
+        except Exception as e:
+            logger.error(f"Failed to invalidate user claims: {str(e)}")
+            return False
+
+    async def invalidate_user_sessions(self, user_id: str) -> bool:
+        """Revoke every cached session and claims entry for a user
+
+        Called on logout and on role/status changes so no request keeps
+        running with a stale identity.
+        """
+        try:
+            set_key = f"user_tokens:{user_id}"
+            tokens = await self.redis.smembers(set_key)
+            pipe = self.redis.pipeline()
+            for token in tokens:
+                pipe.delete(f"session:{token}")
+                pipe.delete(f"user_claims:{self._token_hash(token)}")
+            pipe.delete(set_key)
+            await pipe.execute()
+            return True
+        except Exception as e:
+            logger.error(f"Failed to invalidate user sessions: {str(e)}")
+            return False
+
     # Rate Limiting
     async def check_rate_limit(self, identifier: str, limit: int, window_seconds: int = 60) -> Dict[str, Any]:
-        """Check and update rate limit using sliding window"""
+        """Check and update rate limit using sliding window
+
+        Runs a single atomic Lua script (prune + add + count + expire) instead
+        of a multi-command pipeline. Identifiers last seen far under 50% of
+        their limit may absorb up to RATE_LIMIT_LOCAL_BURST hits in a
+        per-process micro-cache for up to RATE_LIMIT_LOCAL_TTL seconds, so
+        the common case costs zero network hops. Absorbed hits are recorded
+        locally and written back into the window (as extra ZADD members in
+        the same script call) the next time the identifier reaches Redis,
+        so the fast path amortizes round trips without under-counting.
+        """
+        # Local fast path for identifiers well under their limit
+        cached = self._rate_limit_local.get(identifier)
+        absorbed_hits: list = []
+        if cached and time.monotonic() < cached["expires"] and cached["limit"] == limit:
+            if (cached["current"] + 1 < limit * 0.5
+                    and len(cached["absorbed"]) + 1 < self.RATE_LIMIT_LOCAL_BURST):
+                cached["current"] += 1
+                cached["absorbed"].append(time.time())
+                return {
+                    "allowed": True,
+                    "limit": limit,
+                    "current": cached["current"],
+                    "remaining": limit - cached["current"],
+                    "reset_time": cached["reset_time"],
+                    "cached": True
+                }
+            # Burst spent or estimate approaching the limit - fall through
+            # to Redis, carrying the absorbed hits for write-back
+            absorbed_hits = self._rate_limit_local.pop(identifier)["absorbed"]
+        elif cached:
+            absorbed_hits = self._rate_limit_local.pop(identifier)["absorbed"]
+
         try:
             now = datetime.utcnow()
             window_start = now - timedelta(seconds=window_seconds)
-            
+
             key = f"rate_limit:{identifier}"
-            
-            # Use Redis sorted set for sliding window
-            pipe = self.redis.pipeline()
-            
-            # Remove old entries
-            pipe.zremrangebyscore(key, 0, window_start.timestamp())
-            
-            # Add current request
-            pipe.zadd(key, {str(now.timestamp()): now.timestamp()})
-            
-            # Count requests in window
-            pipe.zcard(key)
-            
-            # Set expiration
-            pipe.expire(key, window_seconds * 2)
-            
-            results = await pipe.execute()
-            current_count = results[2]  # zcard result
-            
+
+            if self._rate_limit_script is None:
+                self._rate_limit_script = self.redis.register_script(RATE_LIMIT_LUA)
+
+            current_count, oldest_score = await self._rate_limit_script(
+                keys=[key],
+                args=[
+                    now.timestamp(),
+                    window_start.timestamp(),
+                    str(now.timestamp()),
+                    window_seconds * 2,
+                    *(f"{ts:.6f}" for ts in absorbed_hits)
+                ]
+            )
+            current_count = int(current_count)
+
             is_allowed = current_count <= limit
             remaining = max(0, limit - current_count)
-            
-            # Get reset time (when oldest request will expire)
-            oldest_requests = await self.redis.zrange(key, 0, 0, withscores=True)
+
+            # Reset time (when oldest request will expire)
             reset_time = None
-            if oldest_requests:
-                reset_time = datetime.fromtimestamp(oldest_requests[0][1]) + timedelta(seconds=window_seconds)
-            
+            if float(oldest_score) >= 0:
+                reset_time = datetime.fromtimestamp(float(oldest_score)) + timedelta(seconds=window_seconds)
+            reset_time_str = reset_time.isoformat() + "Z" if reset_time else None
+
+            # Cache identifiers with plenty of headroom for the fast path
+            if current_count < limit * 0.5:
+                self._rate_limit_local[identifier] = {
+                    "expires": time.monotonic() + self.RATE_LIMIT_LOCAL_TTL,
+                    "current": current_count,
+                    "limit": limit,
+                    "reset_time": reset_time_str,
+                    "absorbed": []
+                }
+
             return {
                 "allowed": is_allowed,
                 "limit": limit,
                 "current": current_count,
                 "remaining": remaining,
-                "reset_time": reset_time.isoformat() + "Z" if reset_time else None
+                "reset_time": reset_time_str
             }
-            
+
         except Exception as e:
             logger.error(f"Rate limit check failed: {str(e)}")
             # Allow request on Redis failure
@@ -196,6 +360,10 @@ class RedisManager:
             }
     
     # Node Heartbeat
+    # heartbeat:index is an explicit set of node_ids with heartbeat keys so
+    # fleet-status reads never have to pattern-scan the whole keyspace
+    HEARTBEAT_INDEX_KEY = "heartbeat:index"
+
     async def update_node_heartbeat(self, node_id: str, status_data: Dict[str, Any], ttl: int = 300) -> bool:
         """Update node heartbeat status"""
         try:
@@ -204,7 +372,10 @@ class RedisManager:
                 **status_data,
                 "last_update": datetime.utcnow().isoformat() + "Z"
             }, default=str)
-            await self.redis.setex(key, ttl, data)
+            pipe = self.redis.pipeline()
+            pipe.setex(key, ttl, data)
+            pipe.sadd(self.HEARTBEAT_INDEX_KEY, node_id)
+            await pipe.execute()
             return True
         except Exception as e:
             logger.error(f"Failed to update node heartbeat: {str(e)}")
@@ -223,29 +394,51 @@ class RedisManager:
             return None
     
     async def get_all_node_heartbeats(self) -> Dict[str, Dict[str, Any]]:
-        """Get all node heartbeat statuses"""
+        """Get all node heartbeat statuses
+
+        Reads the heartbeat:index set instead of KEYS pattern-matching the
+        whole keyspace, then fetches every heartbeat in one pipeline. Index
+        entries whose heartbeat key has expired are pruned on the way out.
+        """
         try:
-            pattern = "heartbeat:*"
-            keys = await self.redis.keys(pattern)
-            
-            if not keys:
-                return {}
-            
+            node_ids = await self.redis.smembers(self.HEARTBEAT_INDEX_KEY)
+
+            if not node_ids:
+                # One-time migration for instances populated before the
+                # index existed: seed it with a non-blocking SCAN
+                node_ids = set()
+                async for key in self.redis.scan_iter(match="heartbeat:*"):
+                    suffix = key.split(":", 1)[1]
+                    if suffix != "index":
+                        node_ids.add(suffix)
+                if node_ids:
+                    await self.redis.sadd(self.HEARTBEAT_INDEX_KEY, *node_ids)
+                else:
+                    return {}
+
+            node_ids = sorted(node_ids)
+
             # Use pipeline for efficient bulk retrieval
             pipe = self.redis.pipeline()
-            for key in keys:
-                pipe.get(key)
-            
+            for node_id in node_ids:
+                pipe.get(f"heartbeat:{node_id}")
+
             results = await pipe.execute()
-            
+
             heartbeats = {}
-            for key, data in zip(keys, results):
+            stale_ids = []
+            for node_id, data in zip(node_ids, results):
                 if data:
-                    node_id = key.split(":", 1)[1]
                     heartbeats[node_id] = json.loads(data)
-            
+                else:
+                    stale_ids.append(node_id)
+
+            # Heartbeat TTL expired - drop the node from the index
+            if stale_ids:
+                await self.redis.srem(self.HEARTBEAT_INDEX_KEY, *stale_ids)
+
             return heartbeats
-            
+
         except Exception as e:
             logger.error(f"Failed to get all node heartbeats: {str(e)}")
             return {}
@@ -270,11 +463,13 @@ class RedisManager:
         try:
             key = f"sensor_data:{node_id}"
             data = await self.redis.get(key)
+            REDIS_CACHE_OPS_TOTAL.labels(cache="latest_sensor_data", result="hit" if data else "miss").inc()
             if data:
                 return json.loads(data)
             return None
         except Exception as e:
             logger.error(f"Failed to get cached sensor data: {str(e)}")
+            REDIS_CACHE_OPS_TOTAL.labels(cache="latest_sensor_data", result="error").inc()
             return None
     
     # API Statistics
@@ -0,0 +1,136 @@
+"""
+Smart Greenhouse IoT System - Standalone CoAP Ingest Service
+Runs the CoAP server (app/services/coap_server.py) in its own process pool,
+decoupled from the FastAPI app: a heavy analytics request can no longer stall
+telemetry ACKs, and ingest scales across cores without scaling the whole API.
+
+All workers bind UDP port 5683 with SO_REUSEPORT so the kernel fans incoming
+datagrams out across them. Start with:
+
+    python coap_ingest.py            # COAP_WORKERS processes (default 2)
+
+The api service should run with COAP_ENABLED=false so it skips its embedded
+CoAP server (see docker-compose.yml).
+"""
+
+import asyncio
+import logging
+import multiprocessing
+import os
+import signal
+import socket
+import sys
+
+logging.basicConfig(
+    level=logging.INFO,
+    format='%(asctime)s - %(name)s - %(levelname)s - %(message)s',
+    handlers=[
+        logging.StreamHandler(sys.stdout)
+    ]
+)
+logger = logging.getLogger("coap_ingest")
+
+
+class _ReusePortSocket(socket.socket):
+    """UDP socket that sets SO_REUSEPORT before binding.
+
+    aiocoap creates and binds its server sockets internally with no hook to
+    set options first, so each worker installs this subclass as socket.socket
+    before creating the server context. Every worker then binds the same
+    CoAP port and the kernel load-balances datagrams between them.
+    """
+
+    def bind(self, address):
+        if self.type == socket.SOCK_DGRAM:
+            self.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+        super().bind(address)
+
+
+async def _worker_main(worker_id: int):
+    """Async body of one ingest worker: CoAP server + write-behind buffer"""
+    # Imports happen here so each worker builds its own engine, Redis pool
+    # and event loop instead of inheriting them from the parent process
+    from app.db.database import test_db_connection, close_db
+    from app.utils.redis_utils import init_redis, close_redis
+    from app.services.coap_server import coap_server
+
+    if not await test_db_connection():
+        logger.error(f"💥 Worker {worker_id}: database unreachable, exiting")
+        return 1
+
+    try:
+        await init_redis()
+        logger.info(f"✅ Worker {worker_id}: Redis initialized")
+    except Exception as e:
+        # API-key lookups fall back to the database; ingest keeps working
+        logger.warning(f"⚠️ Worker {worker_id}: Redis unavailable: {e}")
+
+    await coap_server.start()
+    logger.info(f"🚀 Worker {worker_id}: CoAP ingest worker ready on UDP {coap_server.port}")
+
+    shutdown = asyncio.Event()
+    loop = asyncio.get_running_loop()
+    for sig in (signal.SIGTERM, signal.SIGINT):
+        loop.add_signal_handler(sig, shutdown.set)
+
+    await shutdown.wait()
+
+    logger.info(f"🛑 Worker {worker_id}: shutting down...")
+    await coap_server.stop()
+    await close_redis()
+    await close_db()
+    return 0
+
+
+def _run_worker(worker_id: int):
+    """Entrypoint of one worker process"""
+    # Must be installed before aiocoap binds its sockets
+    socket.socket = _ReusePortSocket
+    sys.exit(asyncio.run(_worker_main(worker_id)) or 0)
+
+
+def main():
+    worker_count = int(os.getenv('COAP_WORKERS', '2'))
+    worker_count = max(1, min(worker_count, multiprocessing.cpu_count()))
+
+    logger.info(f"🚀 Starting CoAP ingest service with {worker_count} worker(s) (SO_REUSEPORT)")
+
+    workers = []
+    for worker_id in range(worker_count):
+        process = multiprocessing.Process(
+            target=_run_worker,
+            args=(worker_id,),
+            name=f"coap-ingest-{worker_id}"
+        )
+        process.start()
+        workers.append(process)
+
+    stopping = False
+
+    def _forward_signal(signum, frame):
+        nonlocal stopping
+        stopping = True
+        for process in workers:
+            if process.is_alive():
+                process.terminate()
+
+    signal.signal(signal.SIGTERM, _forward_signal)
+    signal.signal(signal.SIGINT, _forward_signal)
+
+    # Supervise: if a worker dies unexpectedly, take the service down so the
+    # container restart policy brings all workers back in a clean state
+    while any(process.is_alive() for process in workers):
+        for process in workers:
+            process.join(timeout=1)
+            if process.exitcode not in (None, 0) and not stopping:
+                logger.error(f"💥 Worker {process.name} exited with code {process.exitcode} - stopping service")
+                _forward_signal(signal.SIGTERM, None)
+
+    for process in workers:
+        process.join()
+
+    logger.info("🛑 CoAP ingest service stopped")
+
+
+if __name__ == "__main__":
+    main()
@@ -12,6 +12,7 @@ import os
 import asyncio
 import json
 import sys
+import time
 from typing import Optional
 
 # CoAP imports (conditional)
@@ -34,6 +35,22 @@ except ImportError:
     DATABASE_AVAILABLE = False
     logging.warning("Database modules not available - running in simple mode")
 
+# Buffered API audit logging (conditional)
+try:
+    from app.services.api_log_buffer import api_log_buffer
+    API_LOG_BUFFER_AVAILABLE = True
+except ImportError:
+    API_LOG_BUFFER_AVAILABLE = False
+    logging.warning("API log buffer not available - audit logging disabled")
+
+# Incremental zone rollup (conditional)
+try:
+    from app.services.zone_rollup import zone_rollup
+    ZONE_ROLLUP_AVAILABLE = True
+except ImportError:
+    ZONE_ROLLUP_AVAILABLE = False
+    logging.warning("Zone rollup not available - zone_aggregates will not be maintained")
+
 # Configure logging
 logging.basicConfig(
     level=logging.INFO,
@@ -154,25 +171,51 @@ if COAP_AVAILABLE:
                 await self.context.shutdown()
                 logger.info("🔴 CoAP server stopped")
 
+# Deferred startup work for fast-start mode: the schema probes and Redis
+# warm-up run here, after ingest is already accepting traffic
+async def _deferred_startup():
+    """Finish non-critical startup in the background (fast-start mode)"""
+    try:
+        await init_db()
+        logger.info("✅ Database checks completed (deferred)")
+    except Exception as e:
+        logger.warning(f"⚠️ Deferred database checks failed: {e}")
+
+    try:
+        await test_redis_connection()
+        await init_redis()
+        app_state.redis_enabled = True
+        logger.info("✅ Redis initialized (deferred)")
+    except Exception as e:
+        logger.warning(f"⚠️ Redis unavailable: {e}")
+
 # Application lifecycle management
 @asynccontextmanager
 async def lifespan(app: FastAPI):
     """Manage application startup and shutdown"""
     logger.info("🚀 Starting Smart Greenhouse IoT System...")
-    
-    # Initialize database if available
+
+    # Initialize database if available. In fast-start mode only the write
+    # pool is verified here; schema probes and Redis warm-up are deferred so
+    # a container restart costs ~2s of availability instead of ~20s
+    fast_start = False
     if DATABASE_AVAILABLE:
         try:
             settings = get_settings()
+            fast_start = settings.FAST_START
             await test_db_connection()
-            await init_db()
             app_state.database_enabled = True
-            logger.info("✅ Database initialized")
+            if fast_start:
+                logger.info("⚡ Fast start: write pool is up, deferring startup probes")
+            else:
+                await init_db()
+                logger.info("✅ Database initialized")
         except Exception as e:
+            fast_start = False
             logger.warning(f"⚠️ Database unavailable: {e}")
-    
-    # Initialize Redis if available
-    if DATABASE_AVAILABLE:
+
+    # Initialize Redis if available (deferred in fast-start mode)
+    if DATABASE_AVAILABLE and not fast_start:
         try:
             await test_redis_connection()
             await init_redis()
@@ -180,16 +223,40 @@ async def lifespan(app: FastAPI):
             logger.info("✅ Redis initialized")
         except Exception as e:
             logger.warning(f"⚠️ Redis unavailable: {e}")
-    
-    # Start CoAP server if available
-    if COAP_AVAILABLE:
+
+    # Start CoAP server if available (disabled when the standalone
+    # coap_ingest service owns UDP 5683, see docker-compose.yml)
+    coap_enabled = os.getenv('COAP_ENABLED', 'true').lower() == 'true'
+    if COAP_AVAILABLE and coap_enabled:
         try:
             app_state.coap_server = SimpleCoAPServer()
             asyncio.create_task(app_state.coap_server.start())
             logger.info("✅ CoAP server started")
         except Exception as e:
             logger.warning(f"⚠️ CoAP server failed: {e}")
-    
+    elif COAP_AVAILABLE:
+        logger.info("📡 Embedded CoAP server disabled (COAP_ENABLED=false) - handled by coap_ingest service")
+
+    # Finish the deferred probes and warm-up now that ingest is live
+    if fast_start:
+        asyncio.create_task(_deferred_startup())
+
+    # Start buffered audit logger once the database is up
+    if API_LOG_BUFFER_AVAILABLE and app_state.database_enabled:
+        try:
+            await api_log_buffer.start()
+            logger.info("✅ API log buffer started")
+        except Exception as e:
+            logger.warning(f"⚠️ API log buffer failed: {e}")
+
+    # Start incremental zone rollup once the database is up
+    if ZONE_ROLLUP_AVAILABLE and app_state.database_enabled and get_settings().ZONE_ROLLUP_ENABLED:
+        try:
+            await zone_rollup.start()
+            logger.info("✅ Zone rollup started")
+        except Exception as e:
+            logger.warning(f"⚠️ Zone rollup failed: {e}")
+
     logger.info("🎉 Application startup complete!")
     
     yield  # Application runs here
@@ -199,7 +266,22 @@ async def lifespan(app: FastAPI):
     
     if app_state.coap_server:
         await app_state.coap_server.stop()
-    
+
+    if API_LOG_BUFFER_AVAILABLE and app_state.database_enabled:
+        try:
+            await api_log_buffer.stop()
+            logger.info("✅ API log buffer stopped")
+        except Exception as e:
+            logger.error(f"❌ API log buffer stop error: {e}")
+
+    if ZONE_ROLLUP_AVAILABLE and app_state.database_enabled and get_settings().ZONE_ROLLUP_ENABLED:
+        try:
+            await zone_rollup.stop()
+            logger.info("✅ Zone rollup stopped")
+        except Exception as e:
+            logger.error(f"❌ Zone rollup stop error: {e}")
+
+
     if DATABASE_AVAILABLE and app_state.database_enabled:
         try:
             await close_db()
@@ -237,7 +319,28 @@ def create_application() -> FastAPI:
         allow_methods=["*"],
         allow_headers=["*"],
     )
-    
+
+    # Buffered audit logging: record() appends to an in-memory ring and
+    # returns, so request latency never includes audit-log persistence
+    if API_LOG_BUFFER_AVAILABLE:
+        @app.middleware("http")
+        async def audit_log_middleware(request, call_next):
+            started = time.monotonic()
+            response = await call_next(request)
+            if app_state.database_enabled:
+                try:
+                    api_log_buffer.record(
+                        endpoint=request.url.path,
+                        method=request.method,
+                        status_code=response.status_code,
+                        response_time_ms=int((time.monotonic() - started) * 1000),
+                        ip_address=request.client.host if request.client else None,
+                        user_agent=request.headers.get("user-agent")
+                    )
+                except Exception as e:
+                    logger.debug(f"Audit log record failed: {e}")
+            return response
+
     # Root endpoint
     @app.get("/")
     async def root():
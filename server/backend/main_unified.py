@@ -4,7 +4,7 @@ Combines the simplicity of main_simple.py with the robustness of main.py
 """
 
 from fastapi import FastAPI, HTTPException
-from fastapi.responses import JSONResponse
+from fastapi.responses import JSONResponse, Response, StreamingResponse
 from fastapi.middleware.cors import CORSMiddleware
 from contextlib import asynccontextmanager
 import logging
@@ -12,6 +12,7 @@ import os
 import asyncio
 import json
 import sys
+import time
 from typing import Optional
 
 # CoAP imports (conditional)
@@ -34,6 +35,27 @@ except ImportError:
     DATABASE_AVAILABLE = False
     logging.warning("Database modules not available - running in simple mode")
 
+# Live telemetry stream (conditional)
+try:
+    from app.services.telemetry_stream import telemetry_stream
+    TELEMETRY_AVAILABLE = True
+except ImportError:
+    TELEMETRY_AVAILABLE = False
+    logging.warning("Telemetry stream module not available - live streaming disabled")
+
+# Prometheus metrics (conditional)
+try:
+    from app.utils.metrics import (
+        CONTENT_TYPE_LATEST,
+        HTTP_REQUEST_DURATION_SECONDS,
+        render_metrics,
+        update_ingest_buffer_gauges,
+    )
+    METRICS_AVAILABLE = True
+except ImportError:
+    METRICS_AVAILABLE = False
+    logging.warning("Metrics module not available - /metrics endpoint disabled")
+
 # Configure logging
 logging.basicConfig(
     level=logging.INFO,
@@ -99,6 +121,13 @@ if COAP_AVAILABLE:
                             key, value = param.split('=', 1)
                             query_params[key] = value
                 
+                # Fan out to live dashboard streams
+                if TELEMETRY_AVAILABLE and isinstance(sensor_data, dict):
+                    telemetry_stream.publish({
+                        "node_id": query_params.get('node_id', 'unknown'),
+                        **sensor_data
+                    })
+
                 # TODO: Save to database if available
                 response = {
                     "status": "success",
@@ -154,25 +183,51 @@ if COAP_AVAILABLE:
                 await self.context.shutdown()
                 logger.info("🔴 CoAP server stopped")
 
+# Deferred startup work for fast-start mode: the schema probes and Redis
+# warm-up run here, after ingest is already accepting traffic
+async def _deferred_startup():
+    """Finish non-critical startup in the background (fast-start mode)"""
+    try:
+        await init_db()
+        logger.info("✅ Database checks completed (deferred)")
+    except Exception as e:
+        logger.warning(f"⚠️ Deferred database checks failed: {e}")
+
+    try:
+        await test_redis_connection()
+        await init_redis()
+        app_state.redis_enabled = True
+        logger.info("✅ Redis initialized (deferred)")
+    except Exception as e:
+        logger.warning(f"⚠️ Redis unavailable: {e}")
+
 # Application lifecycle management
 @asynccontextmanager
 async def lifespan(app: FastAPI):
     """Manage application startup and shutdown"""
     logger.info("🚀 Starting Smart Greenhouse IoT System...")
-    
-    # Initialize database if available
+
+    # Initialize database if available. In fast-start mode only the write
+    # pool is verified here; schema probes and Redis warm-up are deferred so
+    # a container restart costs ~2s of availability instead of ~20s
+    fast_start = False
     if DATABASE_AVAILABLE:
         try:
             settings = get_settings()
+            fast_start = settings.FAST_START
             await test_db_connection()
-            await init_db()
             app_state.database_enabled = True
-            logger.info("✅ Database initialized")
+            if fast_start:
+                logger.info("⚡ Fast start: write pool is up, deferring startup probes")
+            else:
+                await init_db()
+                logger.info("✅ Database initialized")
         except Exception as e:
+            fast_start = False
             logger.warning(f"⚠️ Database unavailable: {e}")
-    
-    # Initialize Redis if available
-    if DATABASE_AVAILABLE:
+
+    # Initialize Redis if available (deferred in fast-start mode)
+    if DATABASE_AVAILABLE and not fast_start:
         try:
             await test_redis_connection()
             await init_redis()
@@ -180,16 +235,24 @@ async def lifespan(app: FastAPI):
             logger.info("✅ Redis initialized")
         except Exception as e:
             logger.warning(f"⚠️ Redis unavailable: {e}")
-    
-    # Start CoAP server if available
-    if COAP_AVAILABLE:
+
+    # Start CoAP server if available (disabled when the standalone
+    # coap_ingest service owns UDP 5683, see docker-compose.yml)
+    coap_enabled = os.getenv('COAP_ENABLED', 'true').lower() == 'true'
+    if COAP_AVAILABLE and coap_enabled:
         try:
             app_state.coap_server = SimpleCoAPServer()
             asyncio.create_task(app_state.coap_server.start())
             logger.info("✅ CoAP server started")
         except Exception as e:
             logger.warning(f"⚠️ CoAP server failed: {e}")
-    
+    elif COAP_AVAILABLE:
+        logger.info("📡 Embedded CoAP server disabled (COAP_ENABLED=false) - handled by coap_ingest service")
+
+    # Finish the deferred probes and warm-up now that ingest is live
+    if fast_start:
+        asyncio.create_task(_deferred_startup())
+
     logger.info("🎉 Application startup complete!")
     
     yield  # Application runs here
@@ -237,7 +300,22 @@ def create_application() -> FastAPI:
         allow_methods=["*"],
         allow_headers=["*"],
     )
-    
+
+    # Time every HTTP request for Prometheus; use the matched route template
+    # rather than the raw path so node/sensor IDs don't explode cardinality
+    if METRICS_AVAILABLE:
+        @app.middleware("http")
+        async def http_metrics_middleware(request, call_next):
+            started = time.monotonic()
+            response = await call_next(request)
+            route = request.scope.get("route")
+            HTTP_REQUEST_DURATION_SECONDS.labels(
+                method=request.method,
+                path=route.path if route else request.url.path,
+                status=str(response.status_code)
+            ).observe(time.monotonic() - started)
+            return response
+
     # Root endpoint
     @app.get("/")
     async def root():
@@ -289,7 +367,22 @@ def create_application() -> FastAPI:
                 "coap": "coap://localhost:5683/sensor/send-data" if COAP_AVAILABLE else "unavailable"
             }
         }
-    
+
+    @app.get("/metrics")
+    async def prometheus_metrics():
+        """Prometheus metrics in exposition format"""
+        if not METRICS_AVAILABLE:
+            raise HTTPException(status_code=503, detail="Metrics not available")
+        # Gauges for the write-behind buffer are sampled at scrape time and
+        # describe this process only - scrape the coap_ingest workers for
+        # the real ingest numbers when COAP_ENABLED=false here
+        try:
+            from app.services.ingest_buffer import ingest_buffer
+            update_ingest_buffer_gauges(ingest_buffer.stats())
+        except Exception as e:
+            logger.debug(f"Could not sample ingest buffer stats: {e}")
+        return Response(content=render_metrics(), media_type=CONTENT_TYPE_LATEST)
+
     # Mock API endpoints (replace with real implementation when database is available)
     @app.get("/api/v1/sensors")
     async def list_sensors():
@@ -370,6 +463,40 @@ def create_application() -> FastAPI:
             "processed_readings": len(data.get("readings", []))
         }
     
+    @app.get("/api/v1/sensor-data/stream")
+    async def stream_sensor_data(node_id: Optional[str] = None, zone_id: Optional[str] = None):
+        """Server-sent events stream of live sensor readings
+
+        One fan-out per ingested reading regardless of how many dashboard
+        sessions are connected - replaces per-tab polling of
+        /sensor-data/latest. Optional node_id/zone_id filters are applied
+        per subscriber.
+        """
+        if not TELEMETRY_AVAILABLE:
+            raise HTTPException(
+                status_code=503,
+                detail="Live telemetry streaming not available"
+            )
+
+        async def event_source():
+            # Ask EventSource clients to wait 5s before reconnecting
+            yield "retry: 5000\n\n"
+            async for reading in telemetry_stream.subscribe():
+                if node_id and reading.get("node_id") != node_id:
+                    continue
+                if zone_id and reading.get("zone_id") != zone_id:
+                    continue
+                yield f"data: {json.dumps(reading, default=str)}\n\n"
+
+        return StreamingResponse(
+            event_source(),
+            media_type="text/event-stream",
+            headers={
+                "Cache-Control": "no-cache",
+                "X-Accel-Buffering": "no"
+            }
+        )
+
     # Error handler
     @app.exception_handler(404)
     async def not_found_handler(request, exc):
@@ -1,9 +1,49 @@
 -- Smart Greenhouse IoT System - Data Retention and Compression Policies
 -- Configures automatic data lifecycle management for optimal storage and performance
 
+-- Enable columnstore compression BEFORE adding compression policies:
+-- add_compression_policy() errors out on a hypertable that has not been
+-- ALTERed with timescaledb.compress yet
+
+-- Sensor readings: segment by (node_id, sensor_id) so per-sensor range scans
+-- decompress only the segments they touch; time DESC ordering keeps
+-- latest-first queries sequential inside each segment
+ALTER TABLE timeseries.sensor_readings SET (
+    timescaledb.compress,
+    timescaledb.compress_segmentby = 'node_id, sensor_id',
+    timescaledb.compress_orderby = 'time DESC'
+);
+
+ALTER TABLE timeseries.actuator_events SET (
+    timescaledb.compress,
+    timescaledb.compress_segmentby = 'node_id, actuator_id',
+    timescaledb.compress_orderby = 'time DESC'
+);
+
+ALTER TABLE timeseries.node_heartbeats SET (
+    timescaledb.compress,
+    timescaledb.compress_segmentby = 'node_id',
+    timescaledb.compress_orderby = 'time DESC'
+);
+
+ALTER TABLE timeseries.zone_aggregates SET (
+    timescaledb.compress,
+    timescaledb.compress_segmentby = 'zone_id',
+    timescaledb.compress_orderby = 'time DESC'
+);
+
+ALTER TABLE timeseries.system_metrics SET (
+    timescaledb.compress,
+    timescaledb.compress_segmentby = 'metric_name, node_id',
+    timescaledb.compress_orderby = 'time DESC'
+);
+
 -- Compression policies for hypertables (90%+ space savings)
 
--- Compress sensor readings older than 7 days
+-- Compress sensor readings older than 7 days. The continuous aggregates in
+-- 05_create_continuous_aggregates.sql keep refreshing fine: their refresh
+-- windows read compressed chunks transparently, and late backfill into a
+-- compressed chunk is handled by TimescaleDB's compressed-chunk DML
 SELECT add_compression_policy('timeseries.sensor_readings', INTERVAL '7 days');
 
 -- Compress actuator events older than 3 days
@@ -83,36 +123,24 @@ SELECT set_chunk_time_interval('timeseries.node_heartbeats', INTERVAL '1 hour');
 SELECT set_chunk_time_interval('timeseries.zone_aggregates', INTERVAL '1 day');
 SELECT set_chunk_time_interval('timeseries.system_metrics', INTERVAL '1 hour');
 
--- Enable automatic compression for better performance
-ALTER TABLE timeseries.sensor_readings SET (
-    timescaledb.compress,
-    timescaledb.compress_segmentby = 'node_id, sensor_type',
-    timescaledb.compress_orderby = 'time DESC'
-);
-
-ALTER TABLE timeseries.actuator_events SET (
-    timescaledb.compress,
-    timescaledb.compress_segmentby = 'node_id, actuator_id',
-    timescaledb.compress_orderby = 'time DESC'
-);
-
-ALTER TABLE timeseries.node_heartbeats SET (
-    timescaledb.compress,
-    timescaledb.compress_segmentby = 'node_id',
-    timescaledb.compress_orderby = 'time DESC'
-);
-
-ALTER TABLE timeseries.zone_aggregates SET (
-    timescaledb.compress,
-    timescaledb.compress_segmentby = 'zone_id',
-    timescaledb.compress_orderby = 'time DESC'
-);
+-- Sanity check: every timeseries hypertable should now be compression-enabled
+-- with a scheduled compression policy
+DO $$
+DECLARE
+    missing_count integer;
+BEGIN
+    SELECT COUNT(*) INTO missing_count
+    FROM timescaledb_information.hypertables h
+    WHERE h.hypertable_schema = 'timeseries'
+      AND NOT h.compression_enabled;
 
-ALTER TABLE timeseries.system_metrics SET (
-    timescaledb.compress,
-    timescaledb.compress_segmentby = 'metric_name, node_id',
-    timescaledb.compress_orderby = 'time DESC'
-);
+    IF missing_count > 0 THEN
+        RAISE WARNING 'Compression not enabled on % timeseries hypertable(s)', missing_count;
+    ELSE
+        RAISE NOTICE 'Compression enabled on all timeseries hypertables';
+    END IF;
+END;
+$$;
 
 -- Create a maintenance function to optimize hypertables
 CREATE OR REPLACE FUNCTION timeseries.optimize_hypertables()
@@ -0,0 +1,111 @@
+-- Smart Greenhouse IoT System - LTTB Downsampling Function
+-- Largest-Triangle-Three-Buckets downsampling pushed into the database:
+-- long-range charts come back as ~N visually-faithful points (spikes and
+-- glitches preserved) instead of raw rows post-processed in Python
+
+CREATE OR REPLACE FUNCTION timeseries.lttb_downsample(
+    p_node_id VARCHAR,
+    p_sensor_type greenhouse.sensor_type,
+    p_start TIMESTAMPTZ,
+    p_end TIMESTAMPTZ,
+    p_points INTEGER DEFAULT 2000,
+    p_zone_id VARCHAR DEFAULT NULL
+)
+RETURNS TABLE (time TIMESTAMPTZ, value DOUBLE PRECISION)
+LANGUAGE plpgsql STABLE AS $$
+DECLARE
+    times TIMESTAMPTZ[];
+    xs DOUBLE PRECISION[];     -- epoch seconds, for triangle areas
+    vals DOUBLE PRECISION[];
+    n INTEGER;
+    bucket_size DOUBLE PRECISION;
+    a INTEGER := 1;            -- index of the previously selected point
+    i INTEGER;
+    j INTEGER;
+    range_start INTEGER;
+    range_end INTEGER;
+    next_start INTEGER;
+    next_end INTEGER;
+    avg_x DOUBLE PRECISION;
+    avg_y DOUBLE PRECISION;
+    best_area DOUBLE PRECISION;
+    tri_area DOUBLE PRECISION;
+    best_idx INTEGER;
+BEGIN
+    SELECT array_agg(r.time ORDER BY r.time),
+           array_agg(extract(epoch FROM r.time) ORDER BY r.time),
+           array_agg(r.value::double precision ORDER BY r.time)
+      INTO times, xs, vals
+      FROM timeseries.sensor_readings r
+     WHERE r.node_id = p_node_id
+       AND r.sensor_type = p_sensor_type
+       AND r.time >= p_start
+       AND r.time <= p_end
+       AND (p_zone_id IS NULL OR r.zone_id = p_zone_id);
+
+    n := COALESCE(array_length(times, 1), 0);
+    IF n = 0 THEN
+        RETURN;
+    END IF;
+
+    -- Nothing to reduce: return the series as-is
+    IF p_points >= n OR p_points < 3 THEN
+        FOR i IN 1..n LOOP
+            time := times[i];
+            value := vals[i];
+            RETURN NEXT;
+        END LOOP;
+        RETURN;
+    END IF;
+
+    bucket_size := (n - 2)::double precision / (p_points - 2);
+
+    -- First point is always kept
+    time := times[1];
+    value := vals[1];
+    RETURN NEXT;
+
+    FOR i IN 0..(p_points - 3) LOOP
+        range_start := floor(i * bucket_size)::integer + 2;
+        range_end := LEAST(floor((i + 1) * bucket_size)::integer + 1, n - 1);
+
+        -- Third triangle corner: average of the following bucket
+        next_start := floor((i + 1) * bucket_size)::integer + 2;
+        next_end := LEAST(floor((i + 2) * bucket_size)::integer + 1, n);
+        avg_x := 0;
+        avg_y := 0;
+        FOR j IN next_start..next_end LOOP
+            avg_x := avg_x + xs[j];
+            avg_y := avg_y + vals[j];
+        END LOOP;
+        avg_x := avg_x / (next_end - next_start + 1);
+        avg_y := avg_y / (next_end - next_start + 1);
+
+        -- Keep the point forming the largest triangle with the previous
+        -- selection and the next bucket's average
+        best_area := -1;
+        best_idx := range_start;
+        FOR j IN range_start..range_end LOOP
+            tri_area := abs((xs[a] - avg_x) * (vals[j] - vals[a])
+                          - (xs[a] - xs[j]) * (avg_y - vals[a]));
+            IF tri_area > best_area THEN
+                best_area := tri_area;
+                best_idx := j;
+            END IF;
+        END LOOP;
+
+        time := times[best_idx];
+        value := vals[best_idx];
+        RETURN NEXT;
+        a := best_idx;
+    END LOOP;
+
+    -- Last point is always kept
+    time := times[n];
+    value := vals[n];
+    RETURN NEXT;
+END;
+$$;
+
+COMMENT ON FUNCTION timeseries.lttb_downsample IS
+'LTTB downsampling of sensor_readings for one node/sensor_type; returns ~p_points rows preserving visual extremes';
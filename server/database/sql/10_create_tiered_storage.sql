@@ -0,0 +1,86 @@
+-- Smart Greenhouse IoT System - Tiered Storage for Aged Sensor Chunks
+-- Moves sensor_readings chunks older than 90 days onto a cheap-storage
+-- tablespace ("greenhouse_cold", e.g. an HDD or network volume mounted
+-- next to the NVMe data directory). Moved chunks stay attached to the
+-- hypertable, so history queries and bulk exports keep working
+-- transparently - no application changes needed. The compression policy
+-- in 06_create_policies.sql has already rewritten these chunks into
+-- columnar segments by the time they age out of the hot tier, so the
+-- cold volume holds compact column data rather than raw heap pages.
+--
+-- The tablespace itself is provisioned by the operator, e.g.:
+--   CREATE TABLESPACE greenhouse_cold LOCATION '/mnt/cold/greenhouse';
+-- Everything below degrades to a no-op with a WARNING until it exists.
+
+-- Move eligible sensor_readings chunks to the cold tablespace.
+-- reorder_index is skipped: the chunks are compressed already and
+-- move_chunk would have to decompress to reorder
+CREATE OR REPLACE FUNCTION timeseries.tier_cold_chunks(
+    p_older_than INTERVAL DEFAULT INTERVAL '90 days'
+)
+RETURNS integer AS $$
+DECLARE
+    chunk REGCLASS;
+    moved_count integer := 0;
+BEGIN
+    IF NOT EXISTS (SELECT 1 FROM pg_tablespace WHERE spcname = 'greenhouse_cold') THEN
+        RAISE WARNING 'Tablespace greenhouse_cold does not exist - aged chunks stay on the hot tier';
+        RETURN 0;
+    END IF;
+
+    FOR chunk IN
+        SELECT format('%I.%I', c.chunk_schema, c.chunk_name)::regclass
+        FROM timescaledb_information.chunks c
+        WHERE c.hypertable_schema = 'timeseries'
+          AND c.hypertable_name = 'sensor_readings'
+          AND c.range_end < NOW() - p_older_than
+          AND c.chunk_tablespace IS DISTINCT FROM 'greenhouse_cold'
+    LOOP
+        PERFORM move_chunk(
+            chunk => chunk,
+            destination_tablespace => 'greenhouse_cold'
+        );
+        moved_count := moved_count + 1;
+    END LOOP;
+
+    -- Log the tiering operation alongside the other maintenance metrics
+    INSERT INTO timeseries.system_metrics (time, metric_name, metric_value, metric_unit)
+    VALUES (NOW(), 'cold_chunks_moved', moved_count, 'count');
+
+    RETURN moved_count;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Report how much sensor data lives on each tier
+CREATE OR REPLACE FUNCTION timeseries.get_tiering_stats()
+RETURNS TABLE (
+    tier text,
+    chunk_count bigint,
+    total_size_mb numeric,
+    oldest_chunk timestamp with time zone,
+    newest_chunk timestamp with time zone
+) AS $$
+BEGIN
+    RETURN QUERY
+    SELECT
+        CASE WHEN c.chunk_tablespace = 'greenhouse_cold' THEN 'cold' ELSE 'hot' END,
+        COUNT(*),
+        ROUND(SUM(pg_total_relation_size(format('%I.%I', c.chunk_schema, c.chunk_name)::regclass))
+              / 1024.0 / 1024.0, 2),
+        MIN(c.range_start),
+        MAX(c.range_end)
+    FROM timescaledb_information.chunks c
+    WHERE c.hypertable_schema = 'timeseries'
+      AND c.hypertable_name = 'sensor_readings'
+    GROUP BY 1
+    ORDER BY 1;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Schedule tiering nightly, after the API logs cleanup and before the
+-- weekly hypertable optimization window. move_chunk takes a short
+-- exclusive lock per chunk, so run it during the quiet hours
+SELECT cron.schedule('cold_chunk_tiering', '30 2 * * *', 'SELECT timeseries.tier_cold_chunks();');
+
+COMMENT ON FUNCTION timeseries.tier_cold_chunks(INTERVAL) IS 'Moves compressed sensor_readings chunks older than the given interval to the greenhouse_cold tablespace';
+COMMENT ON FUNCTION timeseries.get_tiering_stats() IS 'Returns chunk counts and sizes per storage tier for sensor_readings';
@@ -0,0 +1,32 @@
+-- Smart Greenhouse IoT System - Latest Readings Table
+-- One row per sensor holding its current value, upserted by the ingest
+-- path. "What is the current value" is the most frequent read in the
+-- deployment; this keeps it an O(number of sensors) index lookup that
+-- never touches timeseries.sensor_readings, regardless of history size.
+
+CREATE TABLE timeseries.latest_readings (
+    sensor_id UUID PRIMARY KEY,
+    time TIMESTAMPTZ NOT NULL,
+    node_id VARCHAR(50) NOT NULL,
+    zone_id VARCHAR(10),
+    sensor_type greenhouse.sensor_type NOT NULL,
+    value DECIMAL(10,4) NOT NULL,
+    unit VARCHAR(20) NOT NULL,
+    quality timeseries.data_quality DEFAULT 'good'
+);
+
+-- Current-state queries filter by node (and optionally zone)
+CREATE INDEX idx_latest_readings_node ON timeseries.latest_readings (node_id);
+CREATE INDEX idx_latest_readings_zone ON timeseries.latest_readings (zone_id);
+
+-- Seed from existing history so the table is complete from the first boot;
+-- from then on the ingest upserts keep it fresh
+INSERT INTO timeseries.latest_readings (sensor_id, time, node_id, zone_id, sensor_type, value, unit, quality)
+SELECT DISTINCT ON (sensor_id)
+    sensor_id, time, node_id, zone_id, sensor_type, value, unit, quality
+FROM timeseries.sensor_readings
+WHERE sensor_id IS NOT NULL
+ORDER BY sensor_id, time DESC
+ON CONFLICT (sensor_id) DO NOTHING;
+
+COMMENT ON TABLE timeseries.latest_readings IS 'Current value per sensor, maintained at ingest time';
@@ -0,0 +1,65 @@
+#!/bin/bash
+# Smart Greenhouse CoAP Ingest Gateway - PG fallback smoke test
+#
+# Runs the exact SQL the gateway issues on a Redis cache miss against a
+# live database, so schema drift (renamed columns, enum changes) fails
+# here instead of at the first cold-cache authentication in production.
+# Keep the queries below in sync with src/node_cache.cpp.
+
+set -e
+
+POSTGRES_HOST="${POSTGRES_HOST:-localhost}"
+POSTGRES_PORT="${POSTGRES_PORT:-5432}"
+POSTGRES_DB="${POSTGRES_DB:-greenhouse}"
+POSTGRES_USER="${POSTGRES_USER:-postgres}"
+
+run_sql() {
+    PGPASSWORD="$POSTGRES_PASSWORD" psql -h "$POSTGRES_HOST" -p "$POSTGRES_PORT" \
+        -U "$POSTGRES_USER" -d "$POSTGRES_DB" -v ON_ERROR_STOP=1 -qtA -c "$1"
+}
+
+SMOKE_NODE="smoke_gateway_node"
+SMOKE_KEY="smoke_gateway_key_$$"
+
+cleanup() {
+    run_sql "DELETE FROM greenhouse.nodes WHERE node_id = '$SMOKE_NODE'" > /dev/null || true
+}
+trap cleanup EXIT
+
+echo "=== Gateway PG fallback smoke test ==="
+echo "PostgreSQL Host: $POSTGRES_HOST"
+
+# Seed a throwaway active node to authenticate against
+run_sql "INSERT INTO greenhouse.nodes (node_id, name, api_key, status)
+         VALUES ('$SMOKE_NODE', 'Gateway smoke test', '$SMOKE_KEY', 'active')
+         ON CONFLICT (node_id) DO UPDATE
+         SET api_key = EXCLUDED.api_key, status = 'active'" > /dev/null
+
+# 1. Auth fallback (node_cache.cpp pg_lookup_node)
+resolved=$(run_sql "SELECT node_id FROM greenhouse.nodes
+                    WHERE api_key = '$SMOKE_KEY' AND status = 'active'")
+if [ "$resolved" != "$SMOKE_NODE" ]; then
+    echo "❌ Auth fallback did not resolve the active node (got: '$resolved')"
+    exit 1
+fi
+echo "✅ Auth fallback resolves an active node"
+
+# 2. Non-active nodes must not authenticate
+run_sql "UPDATE greenhouse.nodes SET status = 'inactive'
+         WHERE node_id = '$SMOKE_NODE'" > /dev/null
+resolved=$(run_sql "SELECT node_id FROM greenhouse.nodes
+                    WHERE api_key = '$SMOKE_KEY' AND status = 'active'")
+if [ -n "$resolved" ]; then
+    echo "❌ Auth fallback resolved an inactive node"
+    exit 1
+fi
+echo "✅ Inactive node is rejected"
+
+# 3. Sensor metadata query (node_cache.cpp pg_load_sensors) must execute
+run_sql "SELECT sensor_id::text, sensor_type::text, COALESCE(zone_id, ''),
+                calibration_offset, calibration_multiplier
+         FROM greenhouse.sensors
+         WHERE node_id = '$SMOKE_NODE' AND is_active = true" > /dev/null
+echo "✅ Sensor metadata query executes"
+
+echo "=== PG fallback smoke test passed ==="
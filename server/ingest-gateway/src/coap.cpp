@@ -0,0 +1,118 @@
+// Smart Greenhouse IoT System - Minimal CoAP message codec
+
+#include "coap.hpp"
+
+#include <cstring>
+
+namespace coap {
+
+namespace {
+
+// Decode the extended option delta/length nibbles (RFC 7252 §3.1)
+bool decode_extended(uint8_t nibble, const uint8_t *&p, const uint8_t *end,
+                     uint32_t &value) {
+    if (nibble < 13) {
+        value = nibble;
+        return true;
+    }
+    if (nibble == 13) {
+        if (p >= end) return false;
+        value = 13u + *p++;
+        return true;
+    }
+    if (nibble == 14) {
+        if (p + 2 > end) return false;
+        value = 269u + (static_cast<uint32_t>(p[0]) << 8 | p[1]);
+        p += 2;
+        return true;
+    }
+    return false;  // 15 is reserved (payload marker handled separately)
+}
+
+}  // namespace
+
+bool parse(const uint8_t *data, size_t len, Message &out) {
+    if (len < 4) return false;
+
+    const uint8_t version = data[0] >> 6;
+    if (version != 1) return false;
+
+    out.type = (data[0] >> 4) & 0x03;
+    const uint8_t token_length = data[0] & 0x0F;
+    if (token_length > 8) return false;
+
+    out.code = data[1];
+    out.message_id = static_cast<uint16_t>(data[2]) << 8 | data[3];
+
+    const uint8_t *p = data + 4;
+    const uint8_t *end = data + len;
+
+    if (p + token_length > end) return false;
+    out.token.assign(p, p + token_length);
+    p += token_length;
+
+    out.uri_path.clear();
+    out.uri_query.clear();
+    out.content_format = CONTENT_FORMAT_JSON;
+    out.payload.clear();
+
+    uint32_t option_number = 0;
+    while (p < end) {
+        if (*p == 0xFF) {  // payload marker
+            ++p;
+            if (p >= end) return false;  // marker with no payload is malformed
+            out.payload.assign(reinterpret_cast<const char *>(p), end - p);
+            return true;
+        }
+
+        const uint8_t delta_nibble = *p >> 4;
+        const uint8_t length_nibble = *p & 0x0F;
+        ++p;
+
+        uint32_t delta = 0, option_length = 0;
+        if (!decode_extended(delta_nibble, p, end, delta)) return false;
+        if (!decode_extended(length_nibble, p, end, option_length)) return false;
+        if (p + option_length > end) return false;
+
+        option_number += delta;
+        if (option_number == OPTION_URI_PATH) {
+            out.uri_path.emplace_back(reinterpret_cast<const char *>(p),
+                                      option_length);
+        } else if (option_number == OPTION_CONTENT_FORMAT) {
+            uint32_t cf = 0;
+            for (uint32_t i = 0; i < option_length; ++i) cf = cf << 8 | p[i];
+            out.content_format = static_cast<uint16_t>(cf);
+        } else if (option_number == OPTION_URI_QUERY) {
+            out.uri_query.emplace_back(reinterpret_cast<const char *>(p),
+                                       option_length);
+        }
+        // Other options (Block, ...) are ignored on this path
+        p += option_length;
+    }
+    return true;
+}
+
+std::vector<uint8_t> build_response(const Message &request, uint8_t code,
+                                    const std::string &payload) {
+    std::vector<uint8_t> out;
+    out.reserve(4 + request.token.size() + 1 + payload.size());
+
+    const uint8_t type = (request.type == TYPE_CON) ? TYPE_ACK : TYPE_NON;
+    out.push_back(static_cast<uint8_t>(
+        (1u << 6) | (type << 4) | (request.token.size() & 0x0F)));
+    out.push_back(code);
+    out.push_back(static_cast<uint8_t>(request.message_id >> 8));
+    out.push_back(static_cast<uint8_t>(request.message_id & 0xFF));
+    out.insert(out.end(), request.token.begin(), request.token.end());
+
+    if (!payload.empty()) {
+        // Content-Format: application/json (delta 12, length 1, value 50)
+        out.push_back(0xC1);
+        out.push_back(static_cast<uint8_t>(CONTENT_FORMAT_JSON));
+        out.push_back(0xFF);
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+    return out;
+}
+
+}  // namespace coap
@@ -0,0 +1,60 @@
+// Smart Greenhouse IoT System - Minimal CoAP message codec
+// Parses just enough of RFC 7252 for the sensor ingest path:
+// confirmable/non-confirmable POSTs with Uri-Path, Uri-Query and
+// Content-Format options, and piggybacked ACK responses.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coap {
+
+// Message types
+constexpr uint8_t TYPE_CON = 0;
+constexpr uint8_t TYPE_NON = 1;
+constexpr uint8_t TYPE_ACK = 2;
+constexpr uint8_t TYPE_RST = 3;
+
+// Method / response codes (class.detail packed as class << 5 | detail)
+constexpr uint8_t CODE_EMPTY = 0x00;
+constexpr uint8_t CODE_POST = 0x02;
+constexpr uint8_t CODE_CREATED = 0x41;       // 2.01
+constexpr uint8_t CODE_CHANGED = 0x44;       // 2.04
+constexpr uint8_t CODE_BAD_REQUEST = 0x80;   // 4.00
+constexpr uint8_t CODE_UNAUTHORIZED = 0x81;  // 4.01
+constexpr uint8_t CODE_NOT_FOUND = 0x84;     // 4.04
+constexpr uint8_t CODE_INTERNAL_ERROR = 0xA0;  // 5.00
+
+// Option numbers
+constexpr uint16_t OPTION_URI_PATH = 11;
+constexpr uint16_t OPTION_CONTENT_FORMAT = 12;
+constexpr uint16_t OPTION_URI_QUERY = 15;
+
+// Content formats (must match the Python CoAP server constants)
+constexpr uint16_t CONTENT_FORMAT_JSON = 50;
+constexpr uint16_t CONTENT_FORMAT_CBOR = 60;
+
+struct Message {
+    uint8_t type = TYPE_NON;
+    uint8_t code = CODE_EMPTY;
+    uint16_t message_id = 0;
+    std::vector<uint8_t> token;
+    std::vector<std::string> uri_path;
+    std::vector<std::string> uri_query;  // raw "key=value" segments
+    uint16_t content_format = CONTENT_FORMAT_JSON;
+    std::string payload;
+};
+
+// Parse a datagram. Returns false on anything malformed; the caller
+// drops the packet (matching aiocoap, which never RSTs garbage back
+// at misbehaving firmware).
+bool parse(const uint8_t *data, size_t len, Message &out);
+
+// Build a piggybacked ACK (for CON requests) or NON response carrying
+// the request token, with an optional diagnostic payload.
+std::vector<uint8_t> build_response(const Message &request, uint8_t code,
+                                    const std::string &payload);
+
+}  // namespace coap
@@ -0,0 +1,70 @@
+// Smart Greenhouse IoT System - Ingest gateway configuration
+// Reads the same environment variables docker-compose already passes
+// to the Python backend, so the gateway is drop-in next to it.
+
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+namespace gateway {
+
+struct Config {
+    // CoAP listener
+    std::string coap_host = "0.0.0.0";
+    int coap_port = 5683;
+
+    // PostgreSQL / TimescaleDB
+    std::string pg_host = "localhost";
+    int pg_port = 5432;
+    std::string pg_db = "greenhouse";
+    std::string pg_user = "greenhouse_user";
+    std::string pg_password = "greenhouse_pass";
+
+    // Redis (api_key:{key} cache shared with RedisManager)
+    std::string redis_host = "localhost";
+    int redis_port = 6379;
+
+    // Batching: same triggers as the Python ingest buffer
+    size_t flush_max_rows = 500;
+    int flush_max_age_ms = 250;
+
+    // Matches settings.API_KEY_CACHE_TTL
+    int api_key_cache_ttl = 300;
+
+    static Config from_env() {
+        Config cfg;
+        read_env("COAP_HOST", cfg.coap_host);
+        read_env("COAP_PORT", cfg.coap_port);
+        read_env("POSTGRES_HOST", cfg.pg_host);
+        read_env("POSTGRES_PORT", cfg.pg_port);
+        read_env("POSTGRES_DB", cfg.pg_db);
+        read_env("POSTGRES_USER", cfg.pg_user);
+        read_env("POSTGRES_PASSWORD", cfg.pg_password);
+        read_env("REDIS_HOST", cfg.redis_host);
+        read_env("REDIS_PORT", cfg.redis_port);
+        read_env("INGEST_BUFFER_MAX_ROWS", cfg.flush_max_rows);
+        read_env("INGEST_BUFFER_MAX_AGE_MS", cfg.flush_max_age_ms);
+        read_env("API_KEY_CACHE_TTL", cfg.api_key_cache_ttl);
+        return cfg;
+    }
+
+    std::string pg_conninfo() const {
+        return "host=" + pg_host + " port=" + std::to_string(pg_port) +
+               " dbname=" + pg_db + " user=" + pg_user +
+               " password=" + pg_password;
+    }
+
+  private:
+    static void read_env(const char *name, std::string &out) {
+        if (const char *v = std::getenv(name)) out = v;
+    }
+    static void read_env(const char *name, int &out) {
+        if (const char *v = std::getenv(name)) out = std::atoi(v);
+    }
+    static void read_env(const char *name, size_t &out) {
+        if (const char *v = std::getenv(name)) out = std::strtoul(v, nullptr, 10);
+    }
+};
+
+}  // namespace gateway
@@ -0,0 +1,155 @@
+// Smart Greenhouse IoT System - Batched COPY writer
+
+#include "copy_writer.hpp"
+
+#include <cstdio>
+
+namespace gateway {
+
+namespace {
+
+// Escape a value for COPY text format (tab-separated, \N for NULL)
+std::string copy_escape(const std::string &value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+std::string copy_field(const std::string &value) {
+    return value.empty() ? "\\N" : copy_escape(value);
+}
+
+bool exec_ok(PGconn *pg, const char *sql) {
+    PGresult *res = PQexec(pg, sql);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok)
+        std::fprintf(stderr, "💥 %s failed: %s\n", sql, PQerrorMessage(pg));
+    PQclear(res);
+    return ok;
+}
+
+}  // namespace
+
+CopyWriter::CopyWriter(const Config &cfg, PGconn *pg) : cfg_(cfg), pg_(pg) {}
+
+void CopyWriter::append(ReadingRow row) {
+    if (rows_.empty()) oldest_ = std::chrono::steady_clock::now();
+    rows_.push_back(std::move(row));
+}
+
+bool CopyWriter::flush_due() const {
+    if (rows_.empty()) return false;
+    if (rows_.size() >= cfg_.flush_max_rows) return true;
+    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - oldest_)
+                   .count();
+    return age >= cfg_.flush_max_age_ms;
+}
+
+bool CopyWriter::flush() {
+    if (rows_.empty()) return true;
+
+    if (!exec_ok(pg_, "BEGIN")) {
+        ++failed_flushes;
+        return false;
+    }
+
+    PGresult *res = PQexec(
+        pg_,
+        "COPY timeseries.sensor_readings"
+        " (time, node_id, zone_id, sensor_id, sensor_type, value, unit)"
+        " FROM STDIN");
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        std::fprintf(stderr, "💥 COPY failed to start: %s\n",
+                     PQerrorMessage(pg_));
+        PQclear(res);
+        exec_ok(pg_, "ROLLBACK");
+        ++failed_flushes;
+        return false;
+    }
+    PQclear(res);
+
+    // Track the newest reading per node for the last_seen update
+    std::unordered_map<std::string, std::string> last_seen;
+    char value_buf[32];
+    for (const ReadingRow &row : rows_) {
+        std::snprintf(value_buf, sizeof(value_buf), "%.4f", row.value);
+        std::string line = copy_field(row.time_iso.empty() ? "now" : row.time_iso);
+        line += '\t';
+        line += copy_escape(row.node_id);
+        line += '\t';
+        line += copy_field(row.zone_id);
+        line += '\t';
+        line += copy_field(row.sensor_id);
+        line += '\t';
+        line += copy_escape(row.sensor_type);
+        line += '\t';
+        line += value_buf;
+        line += '\t';
+        line += copy_field(row.unit);
+        line += '\n';
+        if (PQputCopyData(pg_, line.data(), static_cast<int>(line.size())) != 1) {
+            std::fprintf(stderr, "💥 COPY write failed: %s\n",
+                         PQerrorMessage(pg_));
+            PQputCopyEnd(pg_, "write error");
+            exec_ok(pg_, "ROLLBACK");
+            ++failed_flushes;
+            return false;
+        }
+        std::string &seen = last_seen[row.node_id];
+        if (row.time_iso > seen) seen = row.time_iso;
+    }
+
+    if (PQputCopyEnd(pg_, nullptr) != 1) {
+        exec_ok(pg_, "ROLLBACK");
+        ++failed_flushes;
+        return false;
+    }
+    res = PQgetResult(pg_);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok)
+        std::fprintf(stderr, "💥 COPY failed: %s\n", PQerrorMessage(pg_));
+    PQclear(res);
+    while ((res = PQgetResult(pg_)) != nullptr) PQclear(res);
+
+    if (ok) {
+        // Fold last_seen updates into the same transaction, like the
+        // Python ingest buffer does
+        for (const auto &[node_id, seen] : last_seen) {
+            const char *params[2] = {node_id.c_str(), seen.c_str()};
+            PGresult *upd = PQexecParams(
+                pg_,
+                seen.empty()
+                    ? "UPDATE greenhouse.nodes SET last_seen = now()"
+                      " WHERE node_id = $1"
+                    : "UPDATE greenhouse.nodes SET last_seen = $2::timestamptz"
+                      " WHERE node_id = $1",
+                seen.empty() ? 1 : 2, nullptr, params, nullptr, nullptr, 0);
+            if (PQresultStatus(upd) != PGRES_COMMAND_OK)
+                ok = false;
+            PQclear(upd);
+        }
+    }
+
+    if (!ok || !exec_ok(pg_, "COMMIT")) {
+        exec_ok(pg_, "ROLLBACK");
+        ++failed_flushes;
+        return false;
+    }
+
+    total_rows_flushed += rows_.size();
+    ++total_flushes;
+    rows_.clear();
+    return true;
+}
+
+}  // namespace gateway
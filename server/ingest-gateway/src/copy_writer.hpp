@@ -0,0 +1,56 @@
+// Smart Greenhouse IoT System - Batched COPY writer
+// Buffers calibrated readings and streams them into the
+// timeseries.sensor_readings hypertable with COPY FROM STDIN, flushing
+// on the same row-count / age triggers as the Python ingest buffer.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "config.hpp"
+
+namespace gateway {
+
+struct ReadingRow {
+    std::string time_iso;  // ISO 8601 UTC; empty means "use now()"
+    std::string node_id;
+    std::string zone_id;
+    std::string sensor_id;  // UUID, may be empty
+    std::string sensor_type;
+    double value = 0.0;
+    std::string unit;
+};
+
+class CopyWriter {
+  public:
+    CopyWriter(const Config &cfg, PGconn *pg);
+
+    void append(ReadingRow row);
+
+    // True when the batch is full or the oldest buffered row has aged out.
+    bool flush_due() const;
+
+    // COPY the buffered rows and update nodes.last_seen in one transaction.
+    // On failure the batch is kept for the next attempt.
+    bool flush();
+
+    size_t pending() const { return rows_.size(); }
+
+    // Counters for the periodic stats line
+    uint64_t total_rows_flushed = 0;
+    uint64_t total_flushes = 0;
+    uint64_t failed_flushes = 0;
+
+  private:
+    const Config &cfg_;
+    PGconn *pg_;
+    std::vector<ReadingRow> rows_;
+    std::chrono::steady_clock::time_point oldest_;
+};
+
+}  // namespace gateway
@@ -0,0 +1,259 @@
+// Smart Greenhouse IoT System - Native CoAP ingest gateway
+//
+// Standalone replacement for the ingest half of the Python CoAPServerService:
+// terminates CoAP/UDP on the same port and URI paths, validates API keys
+// against the api_key:{key} Redis cache (falling back to greenhouse.nodes),
+// applies per-sensor calibration and streams readings into the
+// timeseries.sensor_readings hypertable with batched COPY.
+//
+// Firmware-compatible by construction: same payload schema, same paths,
+// same response codes — nodes need no changes when ingest moves here.
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "coap.hpp"
+#include "config.hpp"
+#include "copy_writer.hpp"
+#include "node_cache.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handle_signal(int) { g_stop = 1; }
+
+// Sensor value fields accepted in the payload, matching
+// SensorDataResource.process_sensor_data
+const char *kSensorFields[] = {
+    "temperature", "humidity", "soil_moisture",      "light",
+    "ph",          "ec",       "battery_percentage", "signal_strength",
+    "voltage"};
+
+bool is_sensor_path(const std::vector<std::string> &path) {
+    // Same endpoints the Python server registers, plus the /sensor-data
+    // alias used in the firmware docs
+    if (path.empty()) return true;
+    if (path.size() == 1)
+        return path[0] == "sensor" || path[0] == "data" ||
+               path[0] == "sensor-data" || path[0].empty();
+    if (path.size() == 2)
+        return path[0] == "sensor" &&
+               (path[1] == "send-data" || path[1] == "data");
+    return false;
+}
+
+// Look up a "key=value" segment in the parsed Uri-Query options
+std::string query_param(const std::vector<std::string> &query,
+                        const char *key) {
+    const std::string prefix = std::string(key) + "=";
+    for (const std::string &segment : query)
+        if (segment.compare(0, prefix.size(), prefix) == 0)
+            return segment.substr(prefix.size());
+    return "";
+}
+
+// Normalize an epoch or ISO timestamp from the payload; empty = now()
+std::string normalize_timestamp(const json &payload) {
+    if (!payload.contains("timestamp")) return "";
+    const json &ts = payload["timestamp"];
+    if (ts.is_number()) {
+        std::time_t t = static_cast<std::time_t>(ts.get<double>());
+        char buf[32];
+        std::tm tm_utc;
+        gmtime_r(&t, &tm_utc);
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+        return buf;
+    }
+    if (ts.is_string()) return ts.get<std::string>();
+    return "";
+}
+
+struct Gateway {
+    gateway::Config cfg;
+    gateway::NodeCache *nodes = nullptr;
+    gateway::CopyWriter *writer = nullptr;
+    uint64_t requests_ok = 0;
+    uint64_t requests_rejected = 0;
+
+    // Returns the response code and fills response_payload
+    uint8_t handle_request(const coap::Message &msg,
+                           std::string &response_payload) {
+        json payload = json::parse(msg.payload, nullptr, false);
+        if (payload.is_discarded() || !payload.is_object()) {
+            response_payload = R"({"error":"invalid_json"})";
+            return coap::CODE_BAD_REQUEST;
+        }
+
+        // Query-string auth first (the fleet's documented style:
+        // ?api_key=KEY&node_id=NODE with a clean sensor payload), then
+        // fall back to the payload fields for older firmware
+        std::string api_key = query_param(msg.uri_query, "api_key");
+        if (api_key.empty()) api_key = payload.value("api_key", "");
+        std::string node_id = query_param(msg.uri_query, "node_id");
+        if (node_id.empty()) node_id = payload.value("node_id", "");
+
+        if (api_key.empty()) {
+            response_payload = R"({"error":"missing_api_key"})";
+            return coap::CODE_UNAUTHORIZED;
+        }
+        const gateway::NodeInfo *node = nodes->resolve(api_key);
+        if (!node) {
+            response_payload = R"({"error":"invalid_api_key"})";
+            return coap::CODE_UNAUTHORIZED;
+        }
+        // The Python server requires api_key AND node_id to match the
+        // same row; mirror that whenever the claimed node_id is present
+        if (!node_id.empty() && node_id != node->node_id) {
+            response_payload = R"({"error":"invalid_api_key"})";
+            return coap::CODE_UNAUTHORIZED;
+        }
+
+        const std::string zone_id = payload.value("zone_id", "");
+        const std::string time_iso = normalize_timestamp(payload);
+
+        int readings = 0;
+        for (const char *field : kSensorFields) {
+            if (!payload.contains(field) || !payload[field].is_number())
+                continue;
+            auto it = node->sensors.find(field);
+            if (it == node->sensors.end()) continue;  // no active sensor
+            const gateway::SensorInfo &sensor = it->second;
+
+            gateway::ReadingRow row;
+            row.time_iso = time_iso;
+            row.node_id = node->node_id;
+            row.zone_id = zone_id.empty() ? sensor.zone_id : zone_id;
+            row.sensor_id = sensor.sensor_id;
+            row.sensor_type = field;
+            row.value = payload[field].get<double>() *
+                            sensor.calibration_multiplier +
+                        sensor.calibration_offset;
+            row.unit = sensor.unit;
+            writer->append(std::move(row));
+            ++readings;
+        }
+
+        if (readings == 0) {
+            response_payload = R"({"error":"no_sensor_values"})";
+            return coap::CODE_BAD_REQUEST;
+        }
+        response_payload = "{\"success\":true,\"readings_count\":" +
+                           std::to_string(readings) + "}";
+        return coap::CODE_CREATED;
+    }
+};
+
+}  // namespace
+
+int main() {
+    gateway::Config cfg = gateway::Config::from_env();
+
+    PGconn *pg = PQconnectdb(cfg.pg_conninfo().c_str());
+    if (PQstatus(pg) != CONNECTION_OK) {
+        std::fprintf(stderr, "💥 PostgreSQL connection failed: %s\n",
+                     PQerrorMessage(pg));
+        return 1;
+    }
+
+    gateway::NodeCache nodes(cfg, pg);
+    gateway::CopyWriter writer(cfg, pg);
+    Gateway gw{cfg, &nodes, &writer};
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        std::perror("socket");
+        return 1;
+    }
+    int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(cfg.coap_port));
+    inet_pton(AF_INET, cfg.coap_host.c_str(), &addr.sin_addr);
+    if (bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        std::perror("bind");
+        return 1;
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::printf("🚀 CoAP ingest gateway listening on %s:%d\n",
+                cfg.coap_host.c_str(), cfg.coap_port);
+
+    uint8_t buf[2048];
+    time_t last_stats = time(nullptr);
+    while (!g_stop) {
+        pollfd pfd{sock, POLLIN, 0};
+        // Wake up often enough to honor the flush age trigger
+        int ready = poll(&pfd, 1, cfg.flush_max_age_ms / 2 + 1);
+
+        if (ready > 0) {
+            sockaddr_in peer{};
+            socklen_t peer_len = sizeof(peer);
+            ssize_t n = recvfrom(sock, buf, sizeof(buf), 0,
+                                 reinterpret_cast<sockaddr *>(&peer), &peer_len);
+            if (n > 0) {
+                coap::Message msg;
+                if (coap::parse(buf, static_cast<size_t>(n), msg) &&
+                    msg.code == coap::CODE_POST) {
+                    std::string response_payload;
+                    uint8_t code;
+                    if (!is_sensor_path(msg.uri_path)) {
+                        code = coap::CODE_NOT_FOUND;
+                        response_payload = R"({"error":"not_found"})";
+                    } else {
+                        code = gw.handle_request(msg, response_payload);
+                    }
+                    if (code == coap::CODE_CREATED)
+                        ++gw.requests_ok;
+                    else
+                        ++gw.requests_rejected;
+                    auto resp = coap::build_response(msg, code, response_payload);
+                    sendto(sock, resp.data(), resp.size(), 0,
+                           reinterpret_cast<sockaddr *>(&peer), peer_len);
+                }
+                // Malformed datagrams and non-POSTs are dropped silently
+            }
+        }
+
+        if (writer.flush_due()) writer.flush();
+
+        time_t now = time(nullptr);
+        if (now - last_stats >= 60) {
+            std::printf(
+                "📊 ok=%llu rejected=%llu flushed=%llu flushes=%llu "
+                "failed=%llu pending=%zu\n",
+                static_cast<unsigned long long>(gw.requests_ok),
+                static_cast<unsigned long long>(gw.requests_rejected),
+                static_cast<unsigned long long>(writer.total_rows_flushed),
+                static_cast<unsigned long long>(writer.total_flushes),
+                static_cast<unsigned long long>(writer.failed_flushes),
+                writer.pending());
+            std::fflush(stdout);
+            last_stats = now;
+        }
+    }
+
+    // Drain anything still buffered before shutdown
+    writer.flush();
+    close(sock);
+    PQfinish(pg);
+    std::printf("🛑 CoAP ingest gateway stopped\n");
+    return 0;
+}
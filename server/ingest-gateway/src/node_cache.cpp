@@ -0,0 +1,153 @@
+// Smart Greenhouse IoT System - Node auth + sensor metadata cache
+
+#include "node_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace gateway {
+
+namespace {
+
+const char *kUnitForType(const std::string &type) {
+    // Mirrors the unit_map in coap_server.py
+    if (type == "temperature") return "°C";
+    if (type == "humidity" || type == "soil_moisture" ||
+        type == "battery_percentage")
+        return "%";
+    if (type == "light") return "lux";
+    if (type == "ph") return "pH";
+    if (type == "ec") return "μS/cm";
+    if (type == "signal_strength") return "dBm";
+    if (type == "voltage") return "V";
+    return "";
+}
+
+}  // namespace
+
+NodeCache::NodeCache(const Config &cfg, PGconn *pg) : cfg_(cfg), pg_(pg) {
+    redis_connect();
+}
+
+NodeCache::~NodeCache() {
+    if (redis_) redisFree(redis_);
+}
+
+bool NodeCache::redis_connect() {
+    if (redis_) {
+        redisFree(redis_);
+        redis_ = nullptr;
+    }
+    timeval tv{0, 200000};  // 200ms — auth must not stall the ingest loop
+    redis_ = redisConnectWithTimeout(cfg_.redis_host.c_str(), cfg_.redis_port, tv);
+    if (!redis_ || redis_->err) {
+        std::fprintf(stderr, "⚠️ Redis connect failed: %s\n",
+                     redis_ ? redis_->errstr : "alloc");
+        if (redis_) {
+            redisFree(redis_);
+            redis_ = nullptr;
+        }
+        return false;
+    }
+    redisSetTimeout(redis_, tv);
+    return true;
+}
+
+std::optional<std::string> NodeCache::redis_get_node_id(
+    const std::string &api_key) {
+    if (!redis_ && !redis_connect()) return std::nullopt;
+    redisReply *reply = static_cast<redisReply *>(
+        redisCommand(redis_, "GET api_key:%s", api_key.c_str()));
+    if (!reply) {
+        redis_connect();  // connection went away; retry on next request
+        return std::nullopt;
+    }
+    std::optional<std::string> node_id;
+    if (reply->type == REDIS_REPLY_STRING)
+        node_id = std::string(reply->str, reply->len);
+    freeReplyObject(reply);
+    return node_id;
+}
+
+void NodeCache::redis_cache_api_key(const std::string &api_key,
+                                    const std::string &node_id) {
+    if (!redis_) return;
+    redisReply *reply = static_cast<redisReply *>(
+        redisCommand(redis_, "SETEX api_key:%s %d %s", api_key.c_str(),
+                     cfg_.api_key_cache_ttl, node_id.c_str()));
+    if (reply) freeReplyObject(reply);
+}
+
+std::optional<std::string> NodeCache::pg_lookup_node(
+    const std::string &api_key) {
+    const char *params[1] = {api_key.c_str()};
+    PGresult *res = PQexecParams(
+        pg_,
+        "SELECT node_id FROM greenhouse.nodes"
+        " WHERE api_key = $1 AND status = 'active'",
+        1, nullptr, params, nullptr, nullptr, 0);
+    std::optional<std::string> node_id;
+    if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) == 1)
+        node_id = PQgetvalue(res, 0, 0);
+    PQclear(res);
+    return node_id;
+}
+
+bool NodeCache::pg_load_sensors(NodeInfo &node) {
+    const char *params[1] = {node.node_id.c_str()};
+    PGresult *res = PQexecParams(
+        pg_,
+        "SELECT sensor_id::text, sensor_type::text, COALESCE(zone_id, ''),"
+        "       calibration_offset, calibration_multiplier"
+        " FROM greenhouse.sensors"
+        " WHERE node_id = $1 AND is_active = true",
+        1, nullptr, params, nullptr, nullptr, 0);
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        std::fprintf(stderr, "💥 Sensor lookup failed for %s: %s\n",
+                     node.node_id.c_str(), PQerrorMessage(pg_));
+        PQclear(res);
+        return false;
+    }
+    for (int i = 0; i < PQntuples(res); ++i) {
+        SensorInfo s;
+        s.sensor_id = PQgetvalue(res, i, 0);
+        s.sensor_type = PQgetvalue(res, i, 1);
+        s.zone_id = PQgetvalue(res, i, 2);
+        s.calibration_offset = std::atof(PQgetvalue(res, i, 3));
+        s.calibration_multiplier = std::atof(PQgetvalue(res, i, 4));
+        s.unit = kUnitForType(s.sensor_type);
+        // first active sensor per type wins, matching the LIMIT 1 lookup
+        node.sensors.emplace(s.sensor_type, std::move(s));
+    }
+    PQclear(res);
+    return true;
+}
+
+const NodeInfo *NodeCache::resolve(const std::string &api_key) {
+    auto now = std::chrono::steady_clock::now();
+    auto it = cache_.find(api_key);
+    if (it != cache_.end()) {
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(
+                       now - it->second.loaded_at)
+                       .count();
+        if (age < cfg_.api_key_cache_ttl) return &it->second;
+        cache_.erase(it);
+    }
+
+    std::optional<std::string> node_id = redis_get_node_id(api_key);
+    if (!node_id) {
+        node_id = pg_lookup_node(api_key);
+        if (node_id) redis_cache_api_key(api_key, *node_id);
+    }
+    if (!node_id) return nullptr;
+
+    NodeInfo node;
+    node.node_id = *node_id;
+    node.loaded_at = now;
+    if (!pg_load_sensors(node)) return nullptr;
+
+    auto [pos, _] = cache_.emplace(api_key, std::move(node));
+    return &pos->second;
+}
+
+}  // namespace gateway
@@ -0,0 +1,62 @@
+// Smart Greenhouse IoT System - Node auth + sensor metadata cache
+// Resolves api_key -> node the same way verify_node_auth does on the
+// Python side: Redis first (api_key:{key}, written by
+// RedisManager.cache_api_key), then greenhouse.nodes in Postgres with a
+// write-back SETEX. Active sensors (id, calibration, zone) are loaded
+// alongside so readings can be calibrated without a per-request query.
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <hiredis/hiredis.h>
+#include <libpq-fe.h>
+
+#include "config.hpp"
+
+namespace gateway {
+
+struct SensorInfo {
+    std::string sensor_id;  // UUID
+    std::string sensor_type;
+    std::string zone_id;
+    double calibration_offset = 0.0;
+    double calibration_multiplier = 1.0;
+    std::string unit;
+};
+
+struct NodeInfo {
+    std::string node_id;
+    // keyed by sensor_type; one active sensor per type, like the Python path
+    std::unordered_map<std::string, SensorInfo> sensors;
+    std::chrono::steady_clock::time_point loaded_at;
+};
+
+class NodeCache {
+  public:
+    NodeCache(const Config &cfg, PGconn *pg);
+    ~NodeCache();
+
+    // Returns nullptr when the API key is unknown or the node is inactive.
+    // The pointer stays valid until the next resolve() call.
+    const NodeInfo *resolve(const std::string &api_key);
+
+  private:
+    bool redis_connect();
+    std::optional<std::string> redis_get_node_id(const std::string &api_key);
+    void redis_cache_api_key(const std::string &api_key,
+                             const std::string &node_id);
+    std::optional<std::string> pg_lookup_node(const std::string &api_key);
+    bool pg_load_sensors(NodeInfo &node);
+
+    const Config &cfg_;
+    PGconn *pg_;
+    redisContext *redis_ = nullptr;
+    std::unordered_map<std::string, NodeInfo> cache_;  // api_key -> node
+};
+
+}  // namespace gateway